@@ -0,0 +1,74 @@
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "systemDesign/policyCache.hpp"
+
+// Trace Replay: hit ratio of each PolicyCache policy on the same key trace.
+// Every trace entry is a lookup. A miss inserts the key (read-through cache).
+// Usage:
+//   bazel run -c opt //benchmarks:cache_trace_replay                          # synthetic trace
+//   bazel run -c opt //benchmarks:cache_trace_replay -- <trace_file> <capacity>
+// Trace file format: one key per line (any string).
+
+namespace {
+
+// Synthetic workload: a skewed hot set of 2000 keys, with a batch job interleaving a bulk
+// scan of never-reused keys (1 request in 3). Pure LRU lets every scan key push a hot key out.
+std::vector<std::string> syntheticTrace() {
+    std::mt19937 rng(1);
+    std::geometric_distribution<int> hot(0.002); // Small ids are much hotter than large ids
+    std::bernoulli_distribution scan(1.0 / 3);
+    std::vector<std::string> trace;
+    int scanId = 0;
+    for (int i = 0; i < 1'000'000; ++i) {
+        if (scan(rng)) {
+            trace.push_back("scan:" + std::to_string(scanId++));
+        } else {
+            trace.push_back("hot:" + std::to_string(hot(rng) % 2000));
+        }
+    }
+    return trace;
+}
+
+std::vector<std::string> loadTrace(const char* path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error(std::string("cannot open trace file ") + path);
+    }
+    std::vector<std::string> trace;
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty()) {
+            trace.push_back(line);
+        }
+    }
+    return trace;
+}
+
+template <template <typename, typename> class Policy>
+void replay(const char* name, const std::vector<std::string>& trace, size_t capacity) {
+    PolicyCache<std::string, char, Policy> cache(capacity);
+    size_t hits = 0;
+    for (const auto& key : trace) {
+        if (cache.try_get(key)) {
+            ++hits;
+        } else {
+            cache.put(key, 0);
+        }
+    }
+    std::cout << name << "\t" << 100.0 * hits / trace.size() << "% hits" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> trace = argc > 1 ? loadTrace(argv[1]) : syntheticTrace();
+    size_t capacity = argc > 2 ? std::stoul(argv[2]) : 1000;
+
+    std::cout << "requests=" << trace.size() << " capacity=" << capacity << std::endl;
+    replay<LRUPolicy>("LRU    ", trace, capacity);
+    replay<SLRUPolicy>("SLRU   ", trace, capacity);
+    replay<TinyLFUPolicy>("TinyLFU", trace, capacity);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+#include "systemDesign/clockCache.hpp"
+#include "systemDesign/lruCache.hpp"
+#include "systemDesign/shardedLruCache.hpp"
+
+// Read-Heavy Benchmark (95% get / 5% put): LRU designs vs ClockCache.
+//   mutex_lru   : one mutex around LRUCache (every get is a write: splice)
+//   sharded_lru : ShardedLRUCache, 64 shards, each get still takes its shard's exclusive lock
+//   clock       : ClockCache, gets share a reader lock and only set a reference bit
+// Keys fit in the cache, so every get() is a hit.
+// Usage: bazel run -c opt //benchmarks:clock_read_bench
+
+namespace {
+
+constexpr int kKeys = 1 << 16;
+constexpr size_t kOpsPerThread = 1'000'000;
+
+volatile long long gSink = 0;
+
+class MutexLRUCache {
+private:
+    std::mutex mtx;
+    LRUCache<int, int> cache;
+
+public:
+    explicit MutexLRUCache(size_t cap) : cache(cap) {}
+
+    std::optional<int> try_get(int key) {
+        std::lock_guard<std::mutex> lock(mtx);
+        int* v = cache.try_get(key);
+        return v ? std::optional<int>(*v) : std::nullopt;
+    }
+
+    void put(int key, int value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        cache.put(key, value);
+    }
+};
+
+// ShardedLRUCache only has the throwing get(); every key is present, so it never throws here.
+class ShardedAdapter {
+private:
+    ShardedLRUCache<int, int> cache;
+
+public:
+    explicit ShardedAdapter(size_t cap) : cache(64, 2 * cap / 64) {}
+
+    std::optional<int> try_get(int key) { return cache.get(key); }
+    void put(int key, int value) { cache.put(key, value); }
+};
+
+template <typename Cache>
+double run(size_t numThreads) {
+    Cache cache(kKeys);
+    for (int k = 0; k < kKeys; ++k) {
+        cache.put(k, k);
+    }
+
+    std::vector<std::thread> threads;
+    auto st = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&cache, t] {
+            std::mt19937 rng(static_cast<unsigned>(t));
+            std::uniform_int_distribution<int> key(0, kKeys - 1);
+            long long sink = 0;
+            for (size_t i = 0; i < kOpsPerThread; ++i) {
+                int k = key(rng);
+                if (i % 20 == 0) {
+                    cache.put(k, k);
+                } else {
+                    sink += cache.try_get(k).value_or(0);
+                }
+            }
+            gSink = sink;
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - st).count();
+    return numThreads * kOpsPerThread / seconds / 1e6;
+}
+
+} // namespace
+
+int main() {
+    size_t maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    std::cout << "threads\tmutex_lru\tsharded_lru\tclock\t(Mops/s)" << std::endl;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        std::cout << threads << "\t" << run<MutexLRUCache>(threads) << "\t\t"
+                  << run<ShardedAdapter>(threads) << "\t\t" << run<ClockCache<int, int>>(threads)
+                  << std::endl;
+    }
+    return 0;
+}
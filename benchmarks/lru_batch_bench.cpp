@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "systemDesign/lruCache.hpp"
+
+// Batch Lookup Benchmark: try_get() loop vs get_many() on a cache far bigger than the LLC.
+// 4M entries is several hundred MB of list + hash-map nodes, so nearly every lookup is a DRAM miss.
+// Keys are looked up in RPC-sized batches of 256 random keys.
+// Usage: bazel run -c opt //benchmarks:lru_batch_bench
+
+namespace {
+
+constexpr size_t kEntries = 4'000'000;
+constexpr size_t kBatch = 256;
+constexpr size_t kBatches = 8'000;
+
+volatile uint64_t gSink = 0;
+
+using Cache = LRUCache<uint64_t, uint64_t>;
+
+template <typename Lookup>
+void run(const char* name, Cache& cache, const std::vector<uint64_t>& keys, Lookup lookup) {
+    std::vector<uint64_t*> results(kBatch);
+    uint64_t sum = 0;
+    auto st = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < kBatches; ++b) {
+        std::span<const uint64_t> batch(keys.data() + b * kBatch, kBatch);
+        lookup(cache, batch, results);
+        for (uint64_t* v : results) {
+            sum += v ? *v : 0;
+        }
+    }
+    auto et = std::chrono::steady_clock::now();
+    gSink = sum;
+
+    double ns = std::chrono::duration<double, std::nano>(et - st).count() / (kBatches * kBatch);
+    std::cout << name << "\t" << ns << " ns/key" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    Cache cache(kEntries);
+    // Insert in shuffled order so list nodes are not laid out in key order.
+    std::vector<uint64_t> fill(kEntries);
+    for (size_t i = 0; i < kEntries; ++i) fill[i] = i;
+    std::mt19937_64 rng(3);
+    std::shuffle(fill.begin(), fill.end(), rng);
+    for (uint64_t k : fill) {
+        cache.put(k, k);
+    }
+
+    std::uniform_int_distribution<uint64_t> key(0, kEntries - 1);
+    std::vector<uint64_t> keys(kBatches * kBatch);
+    for (auto& k : keys) k = key(rng);
+
+    run("try_get() loop", cache, keys,
+        [](Cache& c, std::span<const uint64_t> batch, std::vector<uint64_t*>& out) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                out[i] = c.try_get(batch[i]);
+            }
+        });
+    run("get_many()    ", cache, keys,
+        [](Cache& c, std::span<const uint64_t> batch, std::vector<uint64_t*>& out) {
+            c.get_many(batch, out);
+        });
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "systemDesign/lruCache.hpp"
+#include "systemDesign/shardedLruCache.hpp"
+
+// Contention Benchmark: one mutex around LRUCache vs ShardedLRUCache.
+// Every thread runs the same 80% get / 20% put mix over a key range that fits in the cache,
+// so every get() is a hit and the only variable is lock contention.
+// Usage: bazel run //benchmarks:lru_contention_bench
+
+namespace {
+
+constexpr size_t kKeys = 1 << 16;
+constexpr size_t kOpsPerThread = 1'000'000;
+constexpr size_t kShards = 64;
+
+// Written once per thread so the compiler cannot drop the get() calls.
+volatile long long gSink = 0;
+
+// Baseline: the "obvious" thread-safe cache, one lock for everything.
+class MutexLRUCache {
+private:
+    std::mutex mtx;
+    LRUCache<int, int> cache;
+
+public:
+    explicit MutexLRUCache(size_t cap) : cache(cap) {}
+
+    int get(int key) {
+        std::lock_guard<std::mutex> lock(mtx);
+        return cache.get(key);
+    }
+
+    void put(int key, int value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        cache.put(key, value);
+    }
+};
+
+template <typename Cache>
+double run(Cache& cache, size_t numThreads) {
+    for (size_t k = 0; k < kKeys; ++k) {
+        cache.put(static_cast<int>(k), static_cast<int>(k));
+    }
+
+    std::vector<std::thread> threads;
+    auto st = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&cache, t] {
+            std::mt19937 rng(static_cast<unsigned>(t));
+            std::uniform_int_distribution<int> key(0, kKeys - 1);
+            long long sink = 0;
+            for (size_t i = 0; i < kOpsPerThread; ++i) {
+                int k = key(rng);
+                if (i % 5 == 0) {
+                    cache.put(k, k);
+                } else {
+                    sink += cache.get(k);
+                }
+            }
+            gSink = sink;
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    auto et = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(et - st).count();
+    return (numThreads * kOpsPerThread) / seconds / 1e6; // Mops/sec
+}
+
+} // namespace
+
+int main() {
+    size_t maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    std::cout << "threads\tmutex_lru(Mops/s)\tsharded_lru(Mops/s)" << std::endl;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        MutexLRUCache single(kKeys);
+        // Keys never spread perfectly evenly, so give each shard 2x headroom to keep every get() a hit.
+        ShardedLRUCache<int, int> sharded(kShards, 2 * kKeys / kShards);
+        double a = run(single, threads);
+        double b = run(sharded, threads);
+        std::cout << threads << "\t" << a << "\t\t\t" << b << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "systemDesign/lruCache.hpp"
+
+// Lookup Benchmark: throwing get() vs non-throwing try_get() on LRUCache.
+// 30% of lookups miss, and values are 4 KB strings, so the "before" path pays
+// exception unwinding on every miss and a full value copy on every hit.
+// Usage: bazel run -c opt //benchmarks:lru_lookup_bench
+
+namespace {
+
+constexpr int kKeys = 10'000;
+constexpr size_t kValueBytes = 4096;
+constexpr size_t kLookups = 1'000'000;
+constexpr double kMissRatio = 0.3;
+
+volatile size_t gSink = 0;
+
+// Keys [0, kKeys) are cached. A miss is drawn from [kKeys, 2 * kKeys).
+std::vector<int> makeTrace() {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> key(0, kKeys - 1);
+    std::bernoulli_distribution miss(kMissRatio);
+    std::vector<int> trace(kLookups);
+    for (auto& k : trace) {
+        k = key(rng) + (miss(rng) ? kKeys : 0);
+    }
+    return trace;
+}
+
+template <typename Lookup>
+void run(const char* name, LRUCache<int, std::string>& cache, const std::vector<int>& trace,
+         Lookup lookup) {
+    size_t bytes = 0;
+    auto st = std::chrono::steady_clock::now();
+    for (int k : trace) {
+        bytes += lookup(cache, k);
+    }
+    auto et = std::chrono::steady_clock::now();
+    gSink = bytes;
+
+    double ns = std::chrono::duration<double, std::nano>(et - st).count() / trace.size();
+    std::cout << name << "\t" << ns << " ns/lookup" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    LRUCache<int, std::string> cache(kKeys);
+    for (int k = 0; k < kKeys; ++k) {
+        cache.put(k, std::string(kValueBytes, 'x'));
+    }
+    std::vector<int> trace = makeTrace();
+
+    // Before: copy on hit, throw on miss
+    run("get() + catch", cache, trace, [](LRUCache<int, std::string>& c, int k) -> size_t {
+        try {
+            return c.get(k).size();
+        } catch (const std::runtime_error&) {
+            return 0;
+        }
+    });
+
+    // After: pointer on hit, nullptr on miss
+    run("try_get()    ", cache, trace, [](LRUCache<int, std::string>& c, int k) -> size_t {
+        const std::string* v = c.try_get(k);
+        return v ? v->size() : 0;
+    });
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "systemDesign/lruCache.hpp"
+#include "systemDesign/pooledLruCache.hpp"
+
+// Allocation Benchmark: LRUCache vs PooledLRUCache at steady-state capacity.
+// The cache is filled once, then every put() is a miss that evicts the LRU entry.
+// Global operator new is replaced so we can count heap allocations per put().
+// Usage: bazel run -c opt //benchmarks:lru_pool_bench
+
+namespace {
+std::atomic<size_t> gAllocations{0};
+volatile long long gSink = 0;
+}
+
+void* operator new(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr size_t kCapacity = 1 << 16;
+constexpr size_t kMisses = 4'000'000;
+
+template <typename Cache>
+void run(const char* name) {
+    Cache cache(kCapacity);
+    for (size_t k = 0; k < kCapacity; ++k) {
+        cache.put(static_cast<long long>(k), static_cast<long long>(k));
+    }
+
+    size_t before = gAllocations.load();
+    auto st = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kMisses; ++i) {
+        long long k = static_cast<long long>(kCapacity + i); // Always a new key -> always evicts
+        cache.put(k, k);
+    }
+    auto et = std::chrono::steady_clock::now();
+    size_t allocs = gAllocations.load() - before;
+    gSink = cache.get(static_cast<long long>(kCapacity + kMisses - 1));
+
+    double ns = std::chrono::duration<double, std::nano>(et - st).count() / kMisses;
+    std::cout << name << "\t" << ns << " ns/put\t"
+              << static_cast<double>(allocs) / kMisses << " allocs/put" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    run<LRUCache<long long, long long>>("LRUCache      ");
+    run<PooledLRUCache<long long, long long>>("PooledLRUCache");
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "systemDesign/lruCache.hpp"
+#include "systemDesign/lruSnapshot.hpp"
+
+// Warm-Start Benchmark: save a full cache, then reload it two ways:
+//   1. loadSnapshot(): mmap + reserve + append_lru (the warm-start path)
+//   2. put() per entry from the same mapped data (the naive path)
+// Usage: bazel run -c opt //benchmarks:lru_snapshot_bench -- [entries] [path]
+// Default: 10M uint64 -> uint64 entries in /tmp/lru_snapshot_bench.bin
+
+namespace {
+
+using Cache = LRUCache<uint64_t, uint64_t>;
+
+double secondsSince(std::chrono::steady_clock::time_point st) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - st).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t entries = argc > 1 ? std::stoul(argv[1]) : 10'000'000;
+    std::string path = argc > 2 ? argv[2] : "/tmp/lru_snapshot_bench.bin";
+
+    {
+        Cache cache(entries);
+        for (uint64_t k = 0; k < entries; ++k) {
+            cache.put(k * 2654435761ULL, k);
+        }
+        auto st = std::chrono::steady_clock::now();
+        saveSnapshot(cache, path);
+        std::cout << "save " << entries << " entries\t" << secondsSince(st) << " s" << std::endl;
+    }
+
+    {
+        Cache cache(entries);
+        auto st = std::chrono::steady_clock::now();
+        size_t loaded = loadSnapshot(cache, path);
+        std::cout << "loadSnapshot()\t\t" << secondsSince(st) << " s (" << loaded << " entries)"
+                  << std::endl;
+    }
+
+    {
+        Cache cache(entries);
+        auto st = std::chrono::steady_clock::now();
+        MappedFile file(path);
+        SnapshotReader in(file.bytes(), file.size());
+        in.take(sizeof(kSnapshotMagic));
+        uint64_t count;
+        in.read(&count, sizeof(count));
+        // put() inserts at the MRU end, so walking the MRU-first file backwards keeps the order.
+        // Read everything first, then replay it in reverse.
+        std::vector<std::pair<uint64_t, uint64_t>> kv(count);
+        for (auto& e : kv) {
+            in.read(&e.first, sizeof(e.first));
+            in.read(&e.second, sizeof(e.second));
+        }
+        for (auto it = kv.rbegin(); it != kv.rend(); ++it) {
+            cache.put(it->first, it->second);
+        }
+        std::cout << "put() per entry\t\t" << secondsSince(st) << " s" << std::endl;
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
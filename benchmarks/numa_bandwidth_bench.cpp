@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "systemDesign/cpuTopology.hpp"
+#include "systemDesign/threadPool.hpp"
+
+// Memory-Bandwidth Benchmark: unplaced ThreadPool vs NUMA-aware, pinned ThreadPool.
+// One 64 MB block per worker; every round each block is summed by one task (pure streaming reads).
+//   unplaced  : main thread allocates + first-touches every block -> all pages on main's node.
+//               Tasks run wherever the scheduler puts them -> on a multi-socket host most reads
+//               cross the interconnect, and all of them hit one node's memory controllers.
+//   numa+pin  : block b belongs to node b % nodes. It is allocated and first-touched by a task
+//               submitted to that node, and summed by tasks submitted to the same node.
+// On a single-node machine both columns should match (nothing to gain, nothing lost).
+// Usage: bazel run -c opt //benchmarks:numa_bandwidth_bench
+
+namespace {
+
+constexpr size_t kBlockBytes = 64 << 20;
+constexpr size_t kWords = kBlockBytes / sizeof(uint64_t);
+constexpr int kRounds = 10;
+volatile uint64_t gSink = 0;
+
+using Block = std::unique_ptr<uint64_t[]>;
+
+Block makeBlock() {
+    Block block(new uint64_t[kWords]); // Not value-initialized: pages are placed on first write below
+    for (size_t i = 0; i < kWords; ++i) {
+        block[i] = i;
+    }
+    return block;
+}
+
+uint64_t sum(const uint64_t* data) {
+    uint64_t s = 0;
+    for (size_t i = 0; i < kWords; ++i) {
+        s += data[i];
+    }
+    return s;
+}
+
+double run(bool placed, size_t threads) {
+    ThreadPool::Options options;
+    options.threads = threads;
+    options.pinWorkers = placed;
+    options.numaAware = placed;
+    ThreadPool pool(options);
+    size_t nodes = placed ? pool.nodes() : 1;
+
+    std::vector<Block> blocks(threads);
+    if (placed) {
+        std::vector<TaskFuture<Block>> made;
+        for (size_t b = 0; b < threads; ++b) {
+            made.push_back(pool.submit_on_node(b % nodes, makeBlock));
+        }
+        for (size_t b = 0; b < threads; ++b) {
+            blocks[b] = made[b].get();
+        }
+    } else {
+        for (auto& block : blocks) {
+            block = makeBlock();
+        }
+    }
+
+    auto st = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        std::vector<TaskFuture<uint64_t>> sums;
+        for (size_t b = 0; b < threads; ++b) {
+            const uint64_t* data = blocks[b].get();
+            if (placed) {
+                sums.push_back(pool.submit_on_node(b % nodes, sum, data));
+            } else {
+                sums.push_back(pool.submit(sum, data));
+            }
+        }
+        for (auto& s : sums) {
+            gSink = gSink + s.get();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - st).count();
+    return static_cast<double>(kBlockBytes) * threads * kRounds / seconds / 1e9;
+}
+
+} // namespace
+
+int main() {
+    CpuTopology topo = CpuTopology::detect();
+    std::cout << "NUMA nodes: " << topo.nodes() << ", CPUs: " << topo.cpus() << std::endl;
+    std::cout << "threads\tunplaced\tnuma+pin\t(GB/s)" << std::endl;
+    for (size_t threads = 1; threads <= topo.cpus(); threads *= 2) {
+        std::cout << threads << "\t" << run(false, threads) << "\t\t" << run(true, threads) << std::endl;
+    }
+    return 0;
+}
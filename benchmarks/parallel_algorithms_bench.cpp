@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "systemDesign/parallelAlgorithms.hpp"
+
+// Parallel Algorithms Scaling Benchmark: 100M uint64 elements (800 MB input + 800 MB output).
+// Each algorithm is timed on a pool of 1, 2, 4, ... N threads, next to the serial std:: version.
+//   for       : out[i] = i * 2654435761 (hash-like store per element)
+//   reduce    : sum of the input
+//   transform : out[i] = in[i] * in[i] + 1
+//   scan      : inclusive prefix sum (two passes over the output: bandwidth bound, scales the least)
+// Every parallel result is checked against the serial one.
+// Usage: bazel run -c opt //benchmarks:parallel_algorithms_bench [-- elements]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F>
+double ms(F&& f) {
+    auto st = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - st).count();
+}
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "MISMATCH in " << what << std::endl;
+        std::exit(1);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 100'000'000;
+    std::vector<uint64_t> in(n), out(n), expected(n);
+    std::iota(in.begin(), in.end(), 1);
+    auto hash = [](uint64_t i) { return i * 2654435761u; };
+    auto square = [](uint64_t x) { return x * x + 1; };
+
+    double serialFor = ms([&] { for (size_t i = 0; i < n; ++i) expected[i] = hash(i); });
+    uint64_t sum = 0;
+    double serialReduce = ms([&] { sum = std::accumulate(in.begin(), in.end(), uint64_t{0}); });
+    double serialTransform = ms([&] { std::transform(in.begin(), in.end(), out.begin(), square); });
+    double serialScan = ms([&] { std::inclusive_scan(in.begin(), in.end(), expected.begin()); });
+
+    std::cout << n << " elements, times in ms (speedup vs serial)" << std::endl;
+    std::cout << "threads\tfor\t\treduce\t\ttransform\tscan" << std::endl;
+    std::cout << "serial\t" << serialFor << "\t\t" << serialReduce << "\t\t" << serialTransform << "\t\t" << serialScan
+              << std::endl;
+
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        double tFor = ms([&] { parallel_for(pool, size_t{0}, n, [&](size_t i) { out[i] = hash(i); }); });
+        check(out[n - 1] == hash(n - 1), "for");
+        uint64_t psum = 0;
+        double tReduce = ms([&] { psum = parallel_reduce(pool, in.begin(), in.end(), uint64_t{0}, std::plus<>()); });
+        check(psum == sum, "reduce");
+        double tTransform = ms([&] { parallel_transform(pool, in.begin(), in.end(), out.begin(), square); });
+        check(out[n / 2] == square(in[n / 2]), "transform");
+        double tScan = ms([&] { parallel_inclusive_scan(pool, in.begin(), in.end(), out.begin(), std::plus<>()); });
+        check(out == expected, "scan");
+
+        std::cout << threads << "\t" << tFor << " (" << serialFor / tFor << "x)\t" << tReduce << " ("
+                  << serialReduce / tReduce << "x)\t" << tTransform << " (" << serialTransform / tTransform << "x)\t"
+                  << tScan << " (" << serialScan / tScan << "x)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchHarness.hpp"
+#include "multithread.hpp"
+
+// Range Count Benchmark (on BenchmarkHarness: warmup, repeated samples, median / p99, optional JSON).
+//   findEven / findOdd : the multithreaded() workload, [0, 1.9e9) (closed form)
+//   <pred>/naive       : `if (i % m == r) ++count` one number at a time, 1 thread (the old findEven loop, but
+//                        with m only known at run time: one 64-bit division per number)
+//   <pred>/scalar/Nt   : residue-stepping kernel, no division, N threads
+//   <pred>/avx2/Nt     : the same in 4 x 64-bit lanes, 8 numbers per iteration (if the CPU has AVX2)
+//   <pred>/closed_form : arithmetic, no scan
+// Scans cover [0, end), end = 2e8 by default; items/s = numbers checked per second.
+// Every result is checked against the closed form first.
+// Usage: bazel run -c opt //benchmarks:range_count_bench -- [end] [--runs=N] [--filter=avx2] [--json=out.json]
+// Compare two commits: run both with --json and diff median_ns per name.
+
+namespace {
+
+void check(ull got, ull expected, const std::string& what) {
+    if (got != expected) {
+        std::cerr << "MISMATCH in " << what << ": " << got << " != " << expected << std::endl;
+        std::exit(1);
+    }
+}
+
+void bench(BenchmarkHarness& harness, ull end, ModulusPredicate pred, const std::string& name) {
+    ull expected = countInRange(0, end, pred);
+    auto naive = [end, pred] {
+        ull count = 0;
+        for (ull i = 0; i < end; ++i) {
+            if (i % pred.modulus == pred.remainder) ++count;
+        }
+        return count;
+    };
+    check(naive(), expected, name + "/naive");
+    harness.run(name + "/naive", [&] { doNotOptimize(naive()); }, end);
+
+    std::vector<RangeKernel> kernels = {RangeKernel::Scalar};
+    if (cpuHasAvx2()) kernels.push_back(RangeKernel::Avx2);
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (RangeKernel kernel : kernels) {
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            RangeCountOptions options;
+            options.closedForm = false;
+            options.kernel = kernel;
+            options.threads = threads;
+            std::string label = name + (kernel == RangeKernel::Avx2 ? "/avx2/" : "/scalar/") +
+                                std::to_string(threads) + "t";
+            check(countInRange(0, end, pred, options), expected, label);
+            harness.run(label, [&] { doNotOptimize(countInRange(0, end, pred, options)); }, end);
+        }
+    }
+    harness.run(name + "/closed_form", [&] { doNotOptimize(countInRange(0, end, pred)); }, end);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkHarness::Options defaults;
+    defaults.warmup = 1;
+    defaults.runs = 10;
+    BenchmarkHarness harness(defaults);
+    std::vector<std::string> args = harness.parseArgs(argc, argv);
+    ull end = args.empty() ? 200'000'000 : std::stoull(args[0]);
+
+    ull workload = 1'900'000'000;
+    check(findEven(0, workload) + findOdd(0, workload), workload, "findEven + findOdd");
+    harness.run("findEven/1.9e9", [&] { doNotOptimize(findEven(0, workload)); });
+    harness.run("findOdd/1.9e9", [&] { doNotOptimize(findOdd(0, workload)); });
+    bench(harness, end, ModulusPredicate::even(), "even");
+    bench(harness, end, ModulusPredicate{7, 3}, "mod7");
+
+    if (!harness.finish()) {
+        std::cerr << "could not write " << harness.settings().json << std::endl;
+        return 1;
+    }
+    return 0;
+}
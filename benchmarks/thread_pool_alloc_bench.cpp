@@ -0,0 +1,118 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include "systemDesign/inlineTask.hpp"
+#include "systemDesign/threadPool.hpp"
+
+// Allocation Benchmark: heap allocations per million tasks.
+// Every task captures 48 bytes (a pointer + 5 longs): more than std::function keeps inline,
+// well within InlineTask<64>.
+// 1. Wrapper only: wrap + invoke + destroy, std::function<void()> vs InlineTask<64>.
+// 2. ThreadPool end to end (shared queue, and work stealing with tasks spawned from a worker).
+// Global operator new is replaced so we can count heap allocations.
+// Usage: bazel run -c opt //benchmarks:thread_pool_alloc_bench
+
+namespace {
+std::atomic<size_t> gAllocations{0};
+}
+
+void* operator new(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::aligned_alloc(static_cast<size_t>(align), (size + static_cast<size_t>(align) - 1) &
+                                                                  ~(static_cast<size_t>(align) - 1))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr size_t kTasks = 1'000'000;
+
+struct Payload {
+    std::atomic<long>* counter;
+    std::array<long, 5> data;
+    void operator()() const { counter->fetch_add(data[0], std::memory_order_relaxed); }
+};
+static_assert(sizeof(Payload) == 48, "48-byte capture");
+
+void report(const char* name, size_t allocations, double seconds) {
+    std::cout << name << "\t" << allocations * 1'000'000 / kTasks << "\t\t"
+              << seconds * 1e9 / kTasks << std::endl;
+}
+
+template <typename Wrapper>
+void wrapperOnly(const char* name) {
+    std::atomic<long> counter{0};
+    size_t before = gAllocations.load();
+    auto st = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kTasks; ++i) {
+        Wrapper task(Payload{&counter, {1, 2, 3, 4, 5}});
+        task();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - st).count();
+    report(name, gAllocations.load() - before, seconds);
+}
+
+void pool(const char* name, bool workStealing) {
+    ThreadPool::Options options;
+    options.threads = 4;
+    options.workStealing = workStealing;
+    ThreadPool pool(options);
+    std::atomic<long> counter{0};
+
+    // Warm up: let the queue / box caches grow to their working size.
+    pool.enqueue([&pool, &counter] {
+        for (size_t i = 0; i < kTasks / 10; ++i) pool.enqueue(Payload{&counter, {1, 2, 3, 4, 5}});
+    });
+    pool.wait_idle();
+
+    size_t before = gAllocations.load();
+    auto st = std::chrono::steady_clock::now();
+    // Spawned from inside a worker: in work-stealing mode this is the local-deque path.
+    pool.enqueue([&pool, &counter] {
+        for (size_t i = 0; i < kTasks; ++i) pool.enqueue(Payload{&counter, {1, 2, 3, 4, 5}});
+    });
+    pool.wait_idle();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - st).count();
+    report(name, gAllocations.load() - before, seconds);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "case\t\t\tallocs/1M tasks\tns/task" << std::endl;
+    wrapperOnly<std::function<void()>>("std::function\t");
+    wrapperOnly<InlineTask<64>>("InlineTask<64>\t");
+    pool("pool shared queue", false);
+    pool("pool work stealing", true);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "systemDesign/threadPool.hpp"
+
+// Fine-Grained Task Benchmark: ThreadPool scheduling overhead with tiny tasks.
+// 1. Nested: 1000 root tasks are enqueued from main; each forks 1000 tiny child tasks from inside
+//    a worker. Shared-queue ThreadPool vs work-stealing ThreadPool:
+//      shared queue : every push and pop takes queueMutex
+//      work stealing: children go to the worker's own lock-free deque; idle workers steal
+// 2. External producers: P threads each enqueue 250k tiny tasks from outside the pool.
+//    Mutex std::queue vs the bounded lock-free MPMC ring (FullPolicy::Block, 4096 slots).
+// 3. Instrumentation cost: the nested work-stealing run with counters only (default),
+//    Options::instrument (task timing), and Options::traceEvents (timing + per-worker trace rings).
+// Usage: bazel run -c opt //benchmarks:thread_pool_bench
+
+namespace {
+
+constexpr int kRoots = 1000;
+constexpr int kChildren = 1000;
+
+double run(bool workStealing, size_t threads, bool instrument = false, size_t traceEvents = 0) {
+    ThreadPool::Options options;
+    options.threads = threads;
+    options.workStealing = workStealing;
+    options.instrument = instrument;
+    options.traceEvents = traceEvents;
+    ThreadPool pool(options);
+    std::atomic<long> done{0};
+
+    auto st = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRoots; ++r) {
+        pool.enqueue([&pool, &done] {
+            for (int c = 0; c < kChildren; ++c) {
+                pool.enqueue([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+    pool.wait_idle();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - st).count();
+    return kRoots * kChildren / seconds / 1e6;
+}
+
+constexpr size_t kProducerTasks = 250'000;
+
+double runProducers(ThreadPool::Queue queue, size_t producers) {
+    ThreadPool::Options options;
+    options.threads = 4;
+    options.queue = queue;
+    options.queueCapacity = 4096;
+    ThreadPool pool(options);
+    std::atomic<long> done{0};
+
+    auto st = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&pool, &done] {
+            for (size_t i = 0; i < kProducerTasks; ++i) {
+                pool.enqueue([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    pool.wait_idle();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - st).count();
+    return producers * kProducerTasks / seconds / 1e6;
+}
+
+} // namespace
+
+int main() {
+    size_t maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    std::cout << "threads\tshared_queue\twork_stealing\t(M tasks/s)" << std::endl;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        std::cout << threads << "\t" << run(false, threads) << "\t\t" << run(true, threads) << std::endl;
+    }
+
+    std::cout << "\nproducers\tmutex_queue\tbounded_ring\t(M tasks/s, 4 workers)" << std::endl;
+    for (size_t producers = 1; producers <= 4; producers *= 2) {
+        std::cout << producers << "\t\t" << runProducers(ThreadPool::Queue::Mutex, producers) << "\t\t"
+                  << runProducers(ThreadPool::Queue::BoundedLockFree, producers) << std::endl;
+    }
+
+    std::cout << "\ncounters\tinstrument\ttrace\t(M tasks/s, work stealing, " << maxThreads << " threads)" << std::endl;
+    std::cout << run(true, maxThreads) << "\t\t" << run(true, maxThreads, true) << "\t\t"
+              << run(true, maxThreads, true, 1 << 16) << std::endl;
+    return 0;
+}
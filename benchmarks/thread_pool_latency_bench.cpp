@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "systemDesign/cacheStats.hpp"
+#include "systemDesign/threadPool.hpp"
+
+// Wake-up Latency Benchmark: enqueue -> start of the task, under bursty load.
+// Main enqueues bursts of kBurst tiny tasks, then goes quiet for `gap`, kBursts times.
+// Each task records (start time - enqueue time) in a LatencyHistogram.
+//   park      : idle workers park on the condition variable at once (default)
+//   spin 50us : idle workers spin (pause) up to 50us, yield 4 times, then park (Options::idleSpin)
+// Short gaps: spinning workers are still awake when the next burst arrives -> no futex wake.
+// Long gaps: everyone parked anyway, both should look alike (the spin budget has shrunk).
+// Percentiles are bucket upper bounds (powers of two, ns).
+// Usage: bazel run -c opt //benchmarks:thread_pool_latency_bench
+
+namespace {
+
+constexpr int kBursts = 2000;
+constexpr int kBurst = 8;
+
+using Clock = std::chrono::steady_clock;
+
+LatencyHistogram::Snapshot run(std::chrono::microseconds spin, std::chrono::microseconds gap, size_t threads) {
+    ThreadPool::Options options;
+    options.threads = threads;
+    options.idleSpin = spin;
+    options.idleYields = spin.count() > 0 ? 4 : 0;
+    ThreadPool pool(options);
+    LatencyHistogram latency;
+
+    for (int b = 0; b < kBursts; ++b) {
+        for (int i = 0; i < kBurst; ++i) {
+            auto queued = Clock::now();
+            pool.enqueue([&latency, queued] {
+                auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - queued);
+                latency.record(static_cast<uint64_t>(waited.count()));
+            });
+        }
+        // Busy-wait the gap: sleep_for would add its own wake-up jitter to main.
+        auto until = Clock::now() + gap;
+        while (Clock::now() < until) {
+        }
+    }
+    pool.wait_idle();
+    return latency.snapshot();
+}
+
+} // namespace
+
+int main() {
+    size_t threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    std::cout << "threads: " << threads << ", " << kBursts << " bursts of " << kBurst << " tasks" << std::endl;
+    std::cout << "gap\tidle\t\tp50\tp90\tp99\tp99.9\t(ns)" << std::endl;
+    for (auto gap : {std::chrono::microseconds(10), std::chrono::microseconds(100), std::chrono::microseconds(1000)}) {
+        for (auto spin : {std::chrono::microseconds(0), std::chrono::microseconds(50)}) {
+            auto s = run(spin, gap, threads);
+            std::cout << gap.count() << "us\t" << (spin.count() ? "spin 50us" : "park\t") << "\t"
+                      << s.percentileNs(50) << "\t" << s.percentileNs(90) << "\t" << s.percentileNs(99) << "\t"
+                      << s.percentileNs(99.9) << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "systemDesign/threadPool.hpp"
+
+// Timer Jitter Benchmark: 10k schedule_after() timers with deadlines spread at random over one second.
+// Each task records how late it started (task start - deadline). Timers never fire early.
+//   timer sleep : the timer thread sleeps on the condition variable right up to each deadline (timerSpin 0)
+//   timer spin  : it wakes 50us early and spins to the deadline (the default)
+//   workers park / spin : idle workers park at once, or spin 50us first (Options::idleSpin)
+// The lateness is the timer thread's own wakeup error plus the enqueue-to-start latency of the pool.
+// Usage: bazel run -c opt //benchmarks:timer_jitter_bench [-- timers]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<int64_t> run(size_t timers, std::chrono::microseconds timerSpin, std::chrono::microseconds idleSpin) {
+    ThreadPool::Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    options.timerSpin = timerSpin;
+    options.idleSpin = idleSpin;
+    options.idleYields = idleSpin.count() > 0 ? 4 : 0;
+    ThreadPool pool(options);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int64_t> offsetUs(10'000, 1'010'000);
+    std::vector<int64_t> lateNs(timers);
+    auto base = Clock::now();
+    for (size_t i = 0; i < timers; ++i) {
+        auto deadline = base + std::chrono::microseconds(offsetUs(rng));
+        pool.schedule_after(deadline - Clock::now(), [&lateNs, i, deadline] {
+            lateNs[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - deadline).count();
+        });
+    }
+    std::this_thread::sleep_until(base + std::chrono::milliseconds(1100));
+    pool.wait_idle();
+    std::sort(lateNs.begin(), lateNs.end());
+    return lateNs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t timers = argc > 1 ? std::stoul(argv[1]) : 10'000;
+    std::cout << timers << " timers over 1s, lateness in us" << std::endl;
+    std::cout << "timer\t\tworkers\tp50\tp99\tp99.9\tmax" << std::endl;
+    for (auto timerSpin : {std::chrono::microseconds(0), std::chrono::microseconds(50)}) {
+        for (auto idleSpin : {std::chrono::microseconds(0), std::chrono::microseconds(50)}) {
+            std::vector<int64_t> late = run(timers, timerSpin, idleSpin);
+            auto pct = [&](double p) { return late[std::min(late.size() - 1, size_t(p / 100 * late.size()))] / 1000.0; };
+            std::cout << (timerSpin.count() ? "spin 50us" : "sleep\t") << "\t" << (idleSpin.count() ? "spin" : "park")
+                      << "\t" << pct(50) << "\t" << pct(99) << "\t" << pct(99.9) << "\t" << late.back() / 1000.0
+                      << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+#ifndef BENCH_HARNESS_HPP
+#define BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Benchmark Harness (warmup, repeated samples, median / p99, JSON)
+// Goal: Numbers that can be compared run to run, instead of one chrono print per function.
+// Mechanics:
+// 1. Why not time once and print: one run is noise (frequency scaling, a cold cache, another process).
+//    Printing inside the timed code also times the print. And `duration.count() / 1000000` on an
+//    integer rounds everything under a second down to 0.
+// 2. Warmup runs first (not recorded): page faults, lazy initialization, CPU frequency ramp-up.
+// 3. Batching: a sample repeats the body `iterations` times, doubling it during warmup until one sample
+//    takes at least minSample. Then a 2 ns body is not drowned by the ~20 ns clock read around it.
+//    Times are reported per call (sample / iterations).
+// 4. Report median (robust to the odd slow sample) and p99 (nearest rank: with fewer than 100 samples
+//    that is the slowest one), plus min / mean / max.
+// 5. Sinks: a result nobody reads can be deleted by the optimizer, and the benchmark then times nothing.
+//    doNotOptimize(x) hands x to an empty asm statement the compiler must assume reads it;
+//    clobberMemory() makes it assume every memory write so far is observed.
+// 6. writeJson(): one object per benchmark (times in ns), for scripts that compare two runs.
+//    Flags: --runs=N --warmup=N --min_sample_ms=N --filter=substr --json=path (see parseFlag).
+
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+struct BenchmarkResult {
+    std::string name;
+    size_t samples = 0;
+    uint64_t iterations = 1; // Calls per sample
+    uint64_t items = 0;      // Work per call (numbers scanned, bytes, ...), 0 = not reported
+    double minNs = 0, medianNs = 0, p99Ns = 0, meanNs = 0, maxNs = 0; // Per call
+
+    double itemsPerSecond() const {
+        return medianNs > 0 ? items * 1e9 / medianNs : 0;
+    }
+};
+
+class BenchmarkHarness {
+public:
+    struct Options {
+        size_t warmup = 2;
+        size_t runs = 15;                          // Samples recorded per benchmark
+        std::chrono::milliseconds minSample{10};   // Batch calls until one sample takes this long
+        std::string filter;                        // Only run benchmarks whose name contains this
+        std::string json;                          // Write JSON here at the end ("-" = stdout)
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Options options;
+    std::vector<BenchmarkResult> results;
+
+    static bool take(const std::string& arg, const std::string& flag, std::string& value) {
+        if (arg.compare(0, flag.size(), flag) != 0) return false;
+        value = arg.substr(flag.size());
+        return true;
+    }
+
+    static void writeEscaped(std::ostream& os, const std::string& s) {
+        os << '"';
+        for (char c : s) {
+            if (c == '"' || c == '\\') os << '\\';
+            os << c;
+        }
+        os << '"';
+    }
+
+public:
+    BenchmarkHarness() = default;
+
+    explicit BenchmarkHarness(Options o) : options(std::move(o)) {}
+
+    // Consume one --flag=value argument. Returns false if it is not one of the harness's flags.
+    bool parseFlag(const std::string& arg) {
+        std::string v;
+        if (take(arg, "--runs=", v)) options.runs = std::max<size_t>(1, std::stoul(v));
+        else if (take(arg, "--warmup=", v)) options.warmup = std::stoul(v);
+        else if (take(arg, "--min_sample_ms=", v)) options.minSample = std::chrono::milliseconds(std::stoul(v));
+        else if (take(arg, "--filter=", v)) options.filter = v;
+        else if (take(arg, "--json=", v)) options.json = v;
+        else return false;
+        return true;
+    }
+
+    // Parse argv: harness flags are consumed, everything else is returned in order.
+    std::vector<std::string> parseArgs(int argc, char** argv) {
+        std::vector<std::string> rest;
+        for (int i = 1; i < argc; ++i) {
+            if (!parseFlag(argv[i])) rest.push_back(argv[i]);
+        }
+        return rest;
+    }
+
+    const Options& settings() const {
+        return options;
+    }
+
+    // Time body() (returns nothing; sink its result with doNotOptimize). `items` = work per call.
+    // Returns nullptr if the filter skipped it (the pointer is valid until the next run()).
+    template <typename F>
+    const BenchmarkResult* run(const std::string& name, F&& body, uint64_t items = 0) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return nullptr;
+
+        auto sample = [&body](uint64_t iterations) {
+            auto st = Clock::now();
+            for (uint64_t i = 0; i < iterations; ++i) {
+                body();
+                clobberMemory();
+            }
+            return std::chrono::duration<double, std::nano>(Clock::now() - st).count();
+        };
+        uint64_t iterations = 1;
+        double minSampleNs = std::chrono::duration<double, std::nano>(options.minSample).count();
+        for (size_t w = 0; w < options.warmup || w == 0; ++w) { // Calibrate on at least one call
+            while (sample(iterations) < minSampleNs && iterations < (uint64_t{1} << 40)) {
+                iterations *= 2;
+            }
+        }
+
+        std::vector<double> perCall(options.runs);
+        for (double& t : perCall) {
+            t = sample(iterations) / iterations;
+        }
+        std::sort(perCall.begin(), perCall.end());
+
+        BenchmarkResult r;
+        r.name = name;
+        r.samples = perCall.size();
+        r.iterations = iterations;
+        r.items = items;
+        r.minNs = perCall.front();
+        r.maxNs = perCall.back();
+        r.medianNs = perCall.size() % 2 ? perCall[perCall.size() / 2]
+                                        : (perCall[perCall.size() / 2 - 1] + perCall[perCall.size() / 2]) / 2;
+        size_t rank = (perCall.size() * 99 + 99) / 100; // ceil(0.99 * n), 1-based
+        r.p99Ns = perCall[rank - 1];
+        r.meanNs = std::accumulate(perCall.begin(), perCall.end(), 0.0) / perCall.size();
+        if (results.empty()) {
+            printHeader(std::cout);
+        }
+        results.push_back(r);
+        printRow(std::cout, results.back());
+        return &results.back();
+    }
+
+    const std::vector<BenchmarkResult>& all() const {
+        return results;
+    }
+
+    static void printHeader(std::ostream& os) {
+        os << std::left << std::setw(36) << "benchmark" << std::right << std::setw(14) << "median" << std::setw(14)
+           << "p99" << std::setw(14) << "min" << std::setw(12) << "samples" << std::setw(16) << "items/s" << std::endl;
+    }
+
+    // Times with a unit that keeps 3-4 significant digits (ns, us, ms or s).
+    static std::string formatNs(double ns) {
+        const char* unit = "ns";
+        for (const char* next : {"us", "ms", "s"}) {
+            if (ns < 1000) break;
+            ns /= 1000;
+            unit = next;
+        }
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(ns < 10 ? 2 : ns < 100 ? 1 : 0) << ns << " " << unit;
+        return out.str();
+    }
+
+    static void printRow(std::ostream& os, const BenchmarkResult& r) {
+        os << std::left << std::setw(36) << r.name << std::right << std::setw(14) << formatNs(r.medianNs)
+           << std::setw(14) << formatNs(r.p99Ns) << std::setw(14) << formatNs(r.minNs) << std::setw(12)
+           << std::to_string(r.samples) + "x" + std::to_string(r.iterations);
+        if (r.items) {
+            std::ostringstream rate;
+            rate << std::setprecision(3) << r.itemsPerSecond();
+            os << std::setw(16) << rate.str();
+        }
+        os << std::endl;
+    }
+
+    // Write the JSON report if --json was given. Returns false if the file could not be written.
+    bool finish() const {
+        if (options.json.empty()) return true;
+        if (options.json == "-") {
+            writeJson(std::cout);
+            return true;
+        }
+        std::ofstream out(options.json);
+        writeJson(out);
+        return static_cast<bool>(out);
+    }
+
+    void writeJson(std::ostream& os) const {
+        os << "{\n  \"context\": {\"hardware_concurrency\": " << std::thread::hardware_concurrency()
+           << ", \"runs\": " << options.runs << ", \"warmup\": " << options.warmup << "},\n  \"benchmarks\": [";
+        const char* sep = "\n";
+        for (const BenchmarkResult& r : results) {
+            std::ostringstream line;
+            line << std::setprecision(12);
+            writeEscaped(line, r.name);
+            line << ", \"samples\": " << r.samples << ", \"iterations\": " << r.iterations
+               << ", \"items\": " << r.items << ", \"min_ns\": " << r.minNs << ", \"median_ns\": " << r.medianNs
+               << ", \"p99_ns\": " << r.p99Ns << ", \"mean_ns\": " << r.meanNs << ", \"max_ns\": " << r.maxNs
+               << ", \"items_per_second\": " << r.itemsPerSecond();
+            os << sep << "    {\"name\": " << line.str() << "}";
+            sep = ",\n";
+        }
+        os << "\n  ]\n}\n";
+    }
+};
+
+#endif // BENCH_HARNESS_HPP
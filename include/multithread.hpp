@@ -1,7 +1,40 @@
 #pragma once
 
+#include <functional>
+
 using ull = unsigned long long;
 
 void multithreaded();
-void findEven(ull start, ull end);
-void findOdd(ull start, ull end);
\ No newline at end of file
+ull findEven(ull start, ull end);
+ull findOdd(ull start, ull end);
+
+// Range counting engine: how many i in [start, end) match a predicate.
+// The range is split into one contiguous chunk per thread; each chunk runs a kernel, the counts are added.
+
+// Kernel used for modulus predicates. Auto = AVX2 if this CPU has it, else Scalar.
+enum class RangeKernel { Auto, Scalar, Avx2 };
+
+struct RangeCountOptions
+{
+    unsigned threads = 0;                    // 0 = std::thread::hardware_concurrency()
+    bool closedForm = true;                  // Modulus predicates: count arithmetically, no scan at all
+    RangeKernel kernel = RangeKernel::Auto;  // When scanning. Avx2 on a CPU without it throws
+};
+
+// i % modulus == remainder. Parity is modulus 2.
+struct ModulusPredicate
+{
+    ull modulus;
+    ull remainder;
+
+    static ModulusPredicate even() { return {2, 0}; }
+    static ModulusPredicate odd() { return {2, 1}; }
+};
+
+bool cpuHasAvx2();
+
+// Throws std::invalid_argument for modulus 0 or remainder >= modulus.
+ull countInRange(ull start, ull end, ModulusPredicate pred, const RangeCountOptions& options = {});
+
+// Any predicate (scalar kernel, split across threads the same way). pred must be safe to call concurrently.
+ull countInRange(ull start, ull end, const std::function<bool(ull)>& pred, unsigned threads = 0);
@@ -0,0 +1,279 @@
+#ifndef CACHE_POLICIES_HPP
+#define CACHE_POLICIES_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Cache Eviction / Admission Policies (used by PolicyCache, see policyCache.hpp)
+// Goal: Keep the hot set resident even when a one-off bulk scan streams through the cache.
+// Problem with pure LRU: every new key goes straight to the MRU position.
+//   A scan of 1M never-reused keys pushes out the whole hot set, and hit rate drops to ~0.
+// Every policy here reuses the LRUCache design (std::list for order + std::unordered_map for lookup),
+// but splits the list into "segments". Moving an entry between segments is a list splice: O(1), no copy.
+//
+// Policy interface (what PolicyCache expects):
+//   explicit Policy(size_t capacity)
+//   V*     find(const K& key)                     // nullptr on miss; records the access
+//   void   insert(const K& key, const V& value)   // key is known absent; may evict (or refuse)
+//   size_t size() const
+
+// Frequency Sketch (Count-Min Sketch)
+// Goal: Estimate "how often have I seen this key recently" in a few bytes per entry.
+// Mechanics:
+// 1. 4 rows of small counters. A key increments one counter per row (different hash per row).
+// 2. frequency(key) = min over the 4 counters. Collisions can only inflate a counter, so min is the best guess.
+// 3. Counters saturate at 15 (TinyLFU only needs "hot vs cold", not exact counts).
+// 4. Aging: after sampleSize increments every counter is halved, so old popularity fades out.
+class FrequencySketch {
+private:
+    static constexpr size_t kDepth = 4;
+    static constexpr uint8_t kMaxCount = 15;
+
+    std::vector<uint8_t> counters; // kDepth rows of `width` counters
+    size_t width;
+    size_t mask;
+    size_t additions = 0;
+    size_t sampleSize;
+
+    size_t indexOf(size_t hash, size_t row) const {
+        uint64_t h = hash + row * 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return row * width + (h & mask);
+    }
+
+    void halve() {
+        for (auto& c : counters) {
+            c >>= 1;
+        }
+        additions /= 2;
+    }
+
+public:
+    explicit FrequencySketch(size_t capacity) {
+        width = 16;
+        while (width < capacity) {
+            width <<= 1;
+        }
+        mask = width - 1;
+        counters.assign(kDepth * width, 0);
+        sampleSize = 10 * width;
+    }
+
+    void increment(size_t hash) {
+        bool added = false;
+        for (size_t row = 0; row < kDepth; ++row) {
+            uint8_t& c = counters[indexOf(hash, row)];
+            if (c < kMaxCount) {
+                ++c;
+                added = true;
+            }
+        }
+        if (added && ++additions >= sampleSize) {
+            halve();
+        }
+    }
+
+    uint8_t frequency(size_t hash) const {
+        uint8_t f = kMaxCount;
+        for (size_t row = 0; row < kDepth; ++row) {
+            f = std::min(f, counters[indexOf(hash, row)]);
+        }
+        return f;
+    }
+};
+
+// Segmented Store: the shared list+map plumbing for all policies.
+// One hash map indexes every entry. Each entry remembers which segment (list) it lives in.
+template <typename K, typename V, size_t NumSegments>
+class SegmentedStore {
+protected:
+    using List = std::list<std::pair<K, V>>;
+
+    struct Entry {
+        typename List::iterator it;
+        size_t segment;
+    };
+
+    std::array<List, NumSegments> segments;
+    std::unordered_map<K, Entry> lookup;
+
+    Entry* locate(const K& key) {
+        auto it = lookup.find(key);
+        return it == lookup.end() ? nullptr : &it->second;
+    }
+
+    // Move an entry to the MRU end of `segment` (may be the segment it is already in).
+    void moveToFront(Entry& e, size_t segment) {
+        segments[segment].splice(segments[segment].begin(), segments[e.segment], e.it);
+        e.segment = segment;
+    }
+
+    void pushFront(const K& key, const V& value, size_t segment) {
+        segments[segment].emplace_front(key, value);
+        lookup[key] = Entry{segments[segment].begin(), segment};
+    }
+
+    // The LRU entry of a (non-empty) segment.
+    Entry& back(size_t segment) {
+        return lookup.find(segments[segment].back().first)->second;
+    }
+
+    void evictBack(size_t segment) {
+        lookup.erase(segments[segment].back().first);
+        segments[segment].pop_back();
+    }
+
+public:
+    size_t size() const {
+        return lookup.size();
+    }
+};
+
+// Policy 1: LRU (baseline). One segment, identical behavior to LRUCache.
+template <typename K, typename V>
+class LRUPolicy : public SegmentedStore<K, V, 1> {
+private:
+    using Base = SegmentedStore<K, V, 1>;
+    size_t capacity;
+
+public:
+    explicit LRUPolicy(size_t cap) : capacity(cap) {}
+
+    V* find(const K& key) {
+        auto* e = this->locate(key);
+        if (!e) return nullptr;
+        this->moveToFront(*e, 0);
+        return &e->it->second;
+    }
+
+    void insert(const K& key, const V& value) {
+        if (this->size() == capacity) {
+            this->evictBack(0);
+        }
+        this->pushFront(key, value, 0);
+    }
+};
+
+// Policy 2: Segmented LRU (SLRU)
+// Mechanics:
+// 1. Probation segment (20%): New keys start here. Evictions happen only from here.
+// 2. Protected segment (80%): A key is promoted here on its SECOND access.
+// 3. If Protected overflows, its LRU entry is demoted back to Probation (second chance, not evicted).
+// A scan touches each key once, so it only ever churns the Probation segment.
+template <typename K, typename V>
+class SLRUPolicy : public SegmentedStore<K, V, 2> {
+private:
+    static constexpr size_t kProbation = 0;
+    static constexpr size_t kProtected = 1;
+
+    size_t capacity;
+    size_t protectedCapacity;
+
+public:
+    explicit SLRUPolicy(size_t cap) : capacity(cap), protectedCapacity(cap * 8 / 10) {}
+
+    V* find(const K& key) {
+        auto* e = this->locate(key);
+        if (!e) return nullptr;
+        this->moveToFront(*e, kProtected);
+        if (this->segments[kProtected].size() > protectedCapacity) {
+            this->moveToFront(this->back(kProtected), kProbation);
+        }
+        return &e->it->second;
+    }
+
+    void insert(const K& key, const V& value) {
+        this->pushFront(key, value, kProbation);
+        if (this->size() > capacity) {
+            this->evictBack(kProbation);
+        }
+    }
+};
+
+// Policy 3: W-TinyLFU (Window TinyLFU, the policy behind Caffeine)
+// Mechanics:
+// 1. Window segment (1%): a tiny plain LRU. Every new key lands here, so bursts still get hits.
+// 2. Main cache (99%): an SLRU (Probation + Protected).
+// 3. Admission: when the Window overflows, its LRU "candidate" must beat the Main cache's
+//    Probation LRU "victim" on estimated frequency (FrequencySketch) to get in.
+//    - Candidate wins: victim is evicted, candidate joins Probation.
+//    - Victim wins: candidate is dropped. One-hit-wonders from a scan never displace hot keys.
+// 4. Every lookup (hit or miss) increments the key's frequency in the sketch.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class TinyLFUPolicy : public SegmentedStore<K, V, 3> {
+private:
+    static constexpr size_t kWindow = 0;
+    static constexpr size_t kProbation = 1;
+    static constexpr size_t kProtected = 2;
+
+    size_t windowCapacity;
+    size_t mainCapacity;
+    size_t protectedCapacity;
+    FrequencySketch sketch;
+    Hash hasher;
+
+    size_t mainSize() const {
+        return this->segments[kProbation].size() + this->segments[kProtected].size();
+    }
+
+    // Window overflowed: decide whether its LRU entry deserves a place in the Main cache.
+    void admitFromWindow() {
+        auto& candidate = this->back(kWindow);
+        if (mainSize() < mainCapacity) {
+            this->moveToFront(candidate, kProbation);
+            return;
+        }
+        if (this->segments[kProbation].empty()) {
+            this->evictBack(kWindow);
+            return;
+        }
+        auto& victim = this->back(kProbation);
+        size_t candidateFreq = sketch.frequency(hasher(candidate.it->first));
+        size_t victimFreq = sketch.frequency(hasher(victim.it->first));
+        if (candidateFreq > victimFreq) {
+            this->evictBack(kProbation);
+            this->moveToFront(candidate, kProbation);
+        } else {
+            this->evictBack(kWindow);
+        }
+    }
+
+public:
+    explicit TinyLFUPolicy(size_t cap)
+        : windowCapacity(std::max<size_t>(1, cap / 100)),
+          mainCapacity(cap - windowCapacity),
+          protectedCapacity(mainCapacity * 8 / 10),
+          sketch(cap) {}
+
+    V* find(const K& key) {
+        sketch.increment(hasher(key));
+        auto* e = this->locate(key);
+        if (!e) return nullptr;
+
+        if (e->segment == kWindow) {
+            this->moveToFront(*e, kWindow);
+        } else {
+            this->moveToFront(*e, kProtected);
+            if (this->segments[kProtected].size() > protectedCapacity) {
+                this->moveToFront(this->back(kProtected), kProbation);
+            }
+        }
+        return &e->it->second;
+    }
+
+    void insert(const K& key, const V& value) {
+        this->pushFront(key, value, kWindow);
+        if (this->segments[kWindow].size() > windowCapacity) {
+            admitFromWindow();
+        }
+    }
+};
+
+#endif // CACHE_POLICIES_HPP
@@ -0,0 +1,167 @@
+#ifndef CACHE_STATS_HPP
+#define CACHE_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Cache Statistics (hit/miss/insert/update/eviction counters + sampled latency histogram)
+// Goal: Tune cache sizes from real numbers, and pay nothing when you don't want them.
+// Mechanics:
+// 1. CacheStats<true>: relaxed std::atomic counters.
+//    - relaxed = "just count", no ordering with other memory. On x86 it is a plain `lock add`
+//      with no fences, and any thread can read a snapshot() while the owner keeps writing.
+// 2. CacheStats<false>: every method is an empty inline function and the class has no members.
+//    Stored with [[no_unique_address]], it takes zero bytes and the optimizer deletes every call.
+// 3. Latency histogram: timing every call would cost more than a cache hit (clock reads ~20 ns),
+//    so only 1 in N calls is timed. Buckets are powers of two in nanoseconds (log2 histogram).
+
+// Log2 latency histogram: bucket i counts samples in [2^i, 2^(i+1)) nanoseconds.
+class LatencyHistogram {
+public:
+    static constexpr size_t kBuckets = 40; // Up to 2^40 ns (~18 minutes)
+
+    struct Snapshot {
+        std::array<uint64_t, kBuckets> buckets{};
+        uint64_t samples = 0;
+
+        // Upper bound (ns) of the bucket containing the p-th percentile, p in [0, 100].
+        uint64_t percentileNs(double p) const {
+            if (samples == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(p / 100.0 * (samples - 1));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBuckets; ++i) {
+                seen += buckets[i];
+                if (seen > rank) return 2ULL << i;
+            }
+            return 2ULL << (kBuckets - 1);
+        }
+    };
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+
+public:
+    void record(uint64_t ns) {
+        size_t b = 0;
+        while (b + 1 < kBuckets && (ns >> (b + 1)) != 0) {
+            ++b;
+        }
+        buckets[b].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            s.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+            s.samples += s.buckets[i];
+        }
+        return s;
+    }
+};
+
+// Point-in-time copy of all counters. Plain struct: cheap to copy, log, or diff.
+struct CacheStatsSnapshot {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t inserts = 0;
+    uint64_t updates = 0;
+    uint64_t evictions = 0;
+    LatencyHistogram::Snapshot getLatency;
+    LatencyHistogram::Snapshot putLatency;
+
+    double hitRatio() const {
+        uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+    }
+};
+
+template <bool Enabled>
+class CacheStats;
+
+// Stats ON
+template <>
+class CacheStats<true> {
+private:
+    std::atomic<uint64_t> hits{0}, misses{0}, inserts{0}, updates{0}, evictions{0};
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint32_t> sampleEvery{0}; // 0 = latency sampling off
+    LatencyHistogram getHist, putHist;
+
+    static void bump(std::atomic<uint64_t>& c) {
+        c.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    // RAII timer: measures from construction to destruction if this call was sampled.
+    class Sample {
+    private:
+        LatencyHistogram* hist;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit Sample(LatencyHistogram* h)
+            : hist(h), start(h ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {}
+        ~Sample() {
+            if (hist) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+                hist->record(static_cast<uint64_t>(ns));
+            }
+        }
+        Sample(const Sample&) = delete;
+        Sample& operator=(const Sample&) = delete;
+    };
+
+    void hit() { bump(hits); }
+    void miss() { bump(misses); }
+    void insert() { bump(inserts); }
+    void update() { bump(updates); }
+    void eviction() { bump(evictions); }
+
+    // Time 1 in `n` get/put calls (0 turns sampling off).
+    void sampleLatencyEvery(uint32_t n) {
+        sampleEvery.store(n, std::memory_order_relaxed);
+    }
+
+    Sample sampleGet() { return Sample(shouldSample() ? &getHist : nullptr); }
+    Sample samplePut() { return Sample(shouldSample() ? &putHist : nullptr); }
+
+    CacheStatsSnapshot snapshot() const {
+        CacheStatsSnapshot s;
+        s.hits = hits.load(std::memory_order_relaxed);
+        s.misses = misses.load(std::memory_order_relaxed);
+        s.inserts = inserts.load(std::memory_order_relaxed);
+        s.updates = updates.load(std::memory_order_relaxed);
+        s.evictions = evictions.load(std::memory_order_relaxed);
+        s.getLatency = getHist.snapshot();
+        s.putLatency = putHist.snapshot();
+        return s;
+    }
+
+private:
+    bool shouldSample() {
+        uint32_t every = sampleEvery.load(std::memory_order_relaxed);
+        return every != 0 && calls.fetch_add(1, std::memory_order_relaxed) % every == 0;
+    }
+};
+
+// Stats OFF: no state, no work. snapshot() is all zeros.
+template <>
+class CacheStats<false> {
+public:
+    struct Sample {};
+
+    void hit() {}
+    void miss() {}
+    void insert() {}
+    void update() {}
+    void eviction() {}
+    void sampleLatencyEvery(uint32_t) {}
+    Sample sampleGet() { return {}; }
+    Sample samplePut() { return {}; }
+    CacheStatsSnapshot snapshot() const { return {}; }
+};
+
+#endif // CACHE_STATS_HPP
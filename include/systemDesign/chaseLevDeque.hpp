@@ -0,0 +1,132 @@
+#ifndef CHASE_LEV_DEQUE_HPP
+#define CHASE_LEV_DEQUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev Work-Stealing Deque (lock-free)
+// Goal: A per-thread task queue that its owner uses like a stack, and other threads can steal from.
+// Mechanics:
+// 1. Owner thread: push() and pop() at the BOTTOM (LIFO). Newest task first -> its data is still hot in cache.
+// 2. Thief threads: steal() from the TOP (FIFO). Oldest task -> usually the biggest chunk of remaining work.
+// 3. Owner and thieves only collide when one element is left. That case is settled with a single
+//    compare_exchange on `top`, so the common path (owner push/pop) has no atomic read-modify-write.
+// 4. The ring buffer grows by doubling when full. Old buffers are kept until the deque dies, because a
+//    slow thief may still be reading from one (simple and safe memory reclamation).
+// Memory orderings follow "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al., PPoPP'13).
+// T must be trivially copyable (store pointers or indices, not objects).
+
+template <typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "ChaseLevDeque stores T in atomics: use a pointer or index");
+
+private:
+    struct Ring {
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Ring(int64_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+        T load(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void store(int64_t i, T v) { slots[i & mask].store(v, std::memory_order_relaxed); }
+    };
+
+    // top and bottom on separate cache lines: thieves hammer `top`, the owner hammers `bottom`.
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<Ring*> ring;
+    std::vector<std::unique_ptr<Ring>> rings; // Owns current + retired rings (owner thread only)
+
+    Ring* grow(Ring* old, int64_t b, int64_t t) {
+        auto bigger = std::make_unique<Ring>(old->capacity * 2);
+        for (int64_t i = t; i < b; ++i) {
+            bigger->store(i, old->load(i));
+        }
+        Ring* raw = bigger.get();
+        rings.push_back(std::move(bigger));
+        ring.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+public:
+    explicit ChaseLevDeque(int64_t initialCapacity = 256) {
+        int64_t cap = 1;
+        while (cap < initialCapacity) cap <<= 1;
+        rings.push_back(std::make_unique<Ring>(cap));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // Owner only.
+    void push(T value) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring* r = ring.load(std::memory_order_relaxed);
+        if (b - t > r->capacity - 1) {
+            r = grow(r, b, t);
+        }
+        r->store(b, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only. Newest element, or nullopt if empty (or a thief won the race for the last one).
+    std::optional<T> pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring* r = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed); // Was empty
+            return std::nullopt;
+        }
+        T value = r->load(b);
+        if (t == b) {
+            // Last element: race against thieves with a CAS on top.
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            if (!won) return std::nullopt;
+        }
+        return value;
+    }
+
+    // Any thread. Oldest element, or nullopt if empty or another thread got there first.
+    std::optional<T> steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return std::nullopt;
+        }
+        Ring* r = ring.load(std::memory_order_acquire);
+        T value = r->load(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return std::nullopt; // Lost the race
+        }
+        return value;
+    }
+
+    // Approximate (racy) size, for heuristics and metrics only.
+    int64_t sizeApprox() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+    bool emptyApprox() const {
+        return sizeApprox() == 0;
+    }
+};
+
+#endif // CHASE_LEV_DEQUE_HPP
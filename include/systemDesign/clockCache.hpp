@@ -0,0 +1,125 @@
+#ifndef CLOCK_CACHE_HPP
+#define CLOCK_CACHE_HPP
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// CLOCK Cache (Second-Chance, approximate LRU)
+// Goal: A thread-safe cache where reads never block each other.
+// Mechanics:
+// 1. Problem: In LRUCache every get() splices the list (a write), so even with sharding a reader
+//    needs an exclusive lock.
+// 2. CLOCK replaces the list with a fixed ring of slots and one "referenced" bit per slot.
+//    - get(): find the slot, set its bit. No list to reorder -> readers share a std::shared_mutex.
+//    - put() on a full cache: the "clock hand" sweeps the ring. A slot with its bit set gets a
+//      second chance (bit cleared, hand moves on). The first slot with a clear bit is the victim.
+//    - Result: recently used entries survive like in LRU, but recency is approximate (1 bit).
+// 3. The bit is only written if it is not already set. A hot key's cache line then stays in the
+//    "shared" state in every core's cache, instead of bouncing between cores on every read.
+// 4. Writers (put) take the exclusive lock. Built for read-heavy workloads (e.g. 95% reads).
+// Note: K and V must be default-constructible (slots are allocated up front).
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class ClockCache {
+private:
+    struct Slot {
+        K key{};
+        V value{};
+        std::atomic<bool> referenced{false}; // Written by readers under the SHARED lock
+    };
+
+    mutable std::shared_mutex mtx;
+    std::vector<Slot> slots;
+    std::unordered_map<K, size_t, Hash> lookup; // Key -> slot index
+    size_t hand = 0;                            // Clock hand: next eviction candidate
+    size_t count = 0;
+
+    static void markReferenced(Slot& slot) {
+        if (!slot.referenced.load(std::memory_order_relaxed)) {
+            slot.referenced.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Sweep until a slot without a second chance is found. Terminates within two laps:
+    // the first lap clears every bit it passes.
+    size_t findVictim() {
+        while (true) {
+            Slot& slot = slots[hand];
+            size_t current = hand;
+            hand = (hand + 1) % slots.size();
+            if (!slot.referenced.exchange(false, std::memory_order_relaxed)) {
+                return current;
+            }
+        }
+    }
+
+public:
+    ClockCache(size_t cap) : slots(cap) {
+        if (cap == 0) {
+            throw std::invalid_argument("ClockCache capacity must be at least 1");
+        }
+        lookup.reserve(cap);
+    }
+
+    // Copy of the value, or std::nullopt on a miss.
+    // Shared lock: any number of readers run in parallel.
+    std::optional<V> try_get(const K& key) {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = lookup.find(key);
+        if (it == lookup.end()) {
+            return std::nullopt;
+        }
+        Slot& slot = slots[it->second];
+        markReferenced(slot); // The only write a reader makes, and it is atomic
+        return slot.value;
+    }
+
+    // Get value by key. Throws std::runtime_error on a miss (same contract as LRUCache).
+    V get(const K& key) {
+        std::optional<V> value = try_get(key);
+        if (!value) {
+            throw std::runtime_error("Key not found");
+        }
+        return std::move(*value);
+    }
+
+    // Insert or Update value. Exclusive lock.
+    void put(const K& key, const V& value) {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        auto it = lookup.find(key);
+        if (it != lookup.end()) {
+            Slot& slot = slots[it->second];
+            slot.value = value;
+            markReferenced(slot);
+            return;
+        }
+
+        // Fill free slots in order first; only sweep once the ring is full.
+        size_t victim;
+        if (count < slots.size()) {
+            victim = count++;
+        } else {
+            victim = findVictim();
+            lookup.erase(slots[victim].key);
+        }
+        Slot& slot = slots[victim];
+        slot.key = key;
+        slot.value = value;
+        // New entries start without a reference: they must be read once to earn a second chance.
+        slot.referenced.store(false, std::memory_order_relaxed);
+        lookup.emplace(key, victim);
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        return count;
+    }
+};
+
+#endif // CLOCK_CACHE_HPP
@@ -0,0 +1,507 @@
+#ifndef CORO_TASK_HPP
+#define CORO_TASK_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "systemDesign/threadPool.hpp"
+
+// Coroutine Tasks on a ThreadPool (C++20)
+// Goal: Write asynchronous code as straight-line code. A coroutine that waits gives its thread back
+//       instead of blocking it, and continues later on a pool worker.
+// Mechanics:
+// 1. CoTask<T>: a lazy coroutine. Nothing runs until it is co_awaited (or passed to sync_wait()).
+//    Awaiting it starts it; when it finishes, the awaiting coroutine continues with the result.
+//    - Hand-off flag: the awaiter (after starting the task) and the finishing task both flip `handoff`.
+//      Whoever comes second continues the awaiter. A task that finished synchronously therefore returns
+//      to the awaiter's loop instead of calling into it, so a million sequential awaits use no more stack
+//      than one. (Symmetric transfer gets the same only where the compiler emits a tail call:
+//      GCC does not at -O0.)
+// 2. co_await schedule_on(pool): suspends and queues "resume me" (one pointer: inline in the pool's task
+//    slot). The rest of the coroutine runs on a pool worker. Until a coroutine awaits something, it runs
+//    on the thread that started it.
+// 3. when_all(tasks...): starts every task and resumes when all have finished (results in order, first
+//    exception rethrown). when_any(tasks): resumes with the first one to finish; the others run to the end
+//    in the background. They only run in parallel if each one hops onto the pool (schedule_on) first.
+// 4. Frame allocator: every coroutine call allocates its frame (locals + state). The compiler may elide
+//    that (HALO) only when it can prove the frame dies inside the caller, which it cannot for tasks handed
+//    to a pool. FrameAllocator recycles frames per thread in 64-byte size classes, so steady-state
+//    coroutine calls do not reach malloc at all.
+// 5. sync_wait(task): the bridge from normal code. Starts the task and blocks until it is done.
+
+// Per-thread free lists of coroutine frames, one per 64-byte size class up to 1 KiB. A frame freed on
+// another thread joins that thread's list (bounded, extra frames go back to the heap).
+class FrameAllocator {
+public:
+    static constexpr size_t kGranule = 64;
+    static constexpr size_t kClasses = 16;    // Frames up to 1 KiB are recycled
+    static constexpr size_t kMaxCached = 256; // Per class and thread
+
+private:
+    struct FreeFrame {
+        FreeFrame* next;
+    };
+
+    struct Lists {
+        std::array<FreeFrame*, kClasses> head{};
+        std::array<size_t, kClasses> count{};
+
+        ~Lists() {
+            for (FreeFrame* f : head) {
+                while (f) ::operator delete(std::exchange(f, f->next));
+            }
+        }
+    };
+
+    static Lists& lists() {
+        static thread_local Lists l;
+        return l;
+    }
+
+    static size_t sizeClass(size_t n) {
+        return (n + kGranule - 1) / kGranule - 1;
+    }
+
+public:
+    static void* allocate(size_t n) {
+        size_t c = sizeClass(n);
+        if (c >= kClasses) {
+            return ::operator new(n);
+        }
+        Lists& l = lists();
+        if (FreeFrame* f = l.head[c]) {
+            l.head[c] = f->next;
+            --l.count[c];
+            return f;
+        }
+        return ::operator new((c + 1) * kGranule);
+    }
+
+    static void deallocate(void* p, size_t n) {
+        size_t c = sizeClass(n);
+        if (c >= kClasses) {
+            ::operator delete(p);
+            return;
+        }
+        Lists& l = lists();
+        if (l.count[c] == kMaxCached) {
+            ::operator delete(p);
+            return;
+        }
+        l.head[c] = new (p) FreeFrame{l.head[c]};
+        ++l.count[c];
+    }
+};
+
+template <typename T = void>
+class CoTask;
+
+namespace coro_detail {
+
+// Frames of every coroutine type in this header come from FrameAllocator.
+struct FramePromise {
+    static void* operator new(size_t n) {
+        return FrameAllocator::allocate(n);
+    }
+    static void operator delete(void* p, size_t n) {
+        FrameAllocator::deallocate(p, n);
+    }
+};
+
+// Resumes the awaiter if it already suspended (the task finished asynchronously).
+// Otherwise the awaiter's await_suspend sees the flag and continues by itself.
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename P>
+    void await_suspend(std::coroutine_handle<P> h) noexcept {
+        auto& p = h.promise();
+        if (p.handoff.exchange(true, std::memory_order_acq_rel)) {
+            p.continuation.resume(); // May destroy this frame: touch nothing after it
+        }
+    }
+    void await_resume() const noexcept {}
+};
+
+template <typename T>
+struct Promise : FramePromise {
+    std::coroutine_handle<> continuation;
+    std::atomic<bool> handoff{false}; // See FinalAwaiter
+    std::variant<std::monostate, T, std::exception_ptr> result;
+
+    CoTask<T> get_return_object();
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+
+    template <typename V>
+    void return_value(V&& v) {
+        result.template emplace<1>(std::forward<V>(v));
+    }
+    void unhandled_exception() {
+        result.template emplace<2>(std::current_exception());
+    }
+
+    T take() {
+        if (result.index() == 2) {
+            std::rethrow_exception(std::get<2>(result));
+        }
+        return std::move(std::get<1>(result));
+    }
+};
+
+template <>
+struct Promise<void> : FramePromise {
+    std::coroutine_handle<> continuation;
+    std::atomic<bool> handoff{false}; // See FinalAwaiter
+    std::exception_ptr error;
+
+    CoTask<void> get_return_object();
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+
+    void return_void() {}
+    void unhandled_exception() {
+        error = std::current_exception();
+    }
+
+    void take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+// Fire-and-forget coroutine: starts at once and frees its own frame when it ends.
+// Used internally to drive child tasks; never lets an exception escape (callers catch inside).
+struct Detached {
+    struct promise_type : FramePromise {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+// void results are stored as std::monostate (when_all tuples, when_any).
+template <typename T>
+using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <typename T>
+CoTask<Stored<T>> storeResult(CoTask<T> task) {
+    if constexpr (std::is_void_v<T>) {
+        co_await std::move(task);
+        co_return std::monostate{};
+    } else {
+        co_return co_await std::move(task);
+    }
+}
+
+} // namespace coro_detail
+
+// Lazy coroutine task returning T. Move-only; owns its frame.
+template <typename T>
+class CoTask {
+public:
+    using promise_type = coro_detail::Promise<T>;
+    using value_type = T;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    CoTask() = default;
+    explicit CoTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    CoTask(CoTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    CoTask& operator=(CoTask&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    CoTask(const CoTask&) = delete;
+    CoTask& operator=(const CoTask&) = delete;
+
+    ~CoTask() {
+        if (handle) handle.destroy();
+    }
+
+    bool valid() const {
+        return static_cast<bool>(handle);
+    }
+
+    // co_await task: start it, resume the awaiter with its result (or rethrow its exception).
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> h;
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                h.promise().continuation = awaiting;
+                h.resume(); // Runs the task until it finishes or suspends
+                return !h.promise().handoff.exchange(true, std::memory_order_acq_rel); // false: finished, go on
+            }
+            T await_resume() {
+                return h.promise().take();
+            }
+        };
+        return Awaiter{handle};
+    }
+};
+
+namespace coro_detail {
+
+template <typename T>
+CoTask<T> Promise<T>::get_return_object() {
+    return CoTask<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline CoTask<void> Promise<void>::get_return_object() {
+    return CoTask<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// Counts down the children of a when_all. Starts at n + 1: the awaiting coroutine's own arrival
+// (await_suspend) is the +1, so whichever of it and the last child comes second resumes it.
+class Latch {
+private:
+    std::atomic<size_t> count;
+    std::coroutine_handle<> waiter;
+
+public:
+    explicit Latch(size_t n) : count(n + 1) {}
+
+    void arrive() {
+        if (count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            waiter.resume();
+        }
+    }
+
+    bool await_ready() const noexcept {
+        return count.load(std::memory_order_acquire) == 1; // Every child finished synchronously
+    }
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        waiter = h;
+        return count.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+    void await_resume() const noexcept {}
+};
+
+template <typename T>
+Detached runChild(CoTask<T> task, std::optional<T>& slot, std::exception_ptr& error,
+                  std::atomic<bool>& failed, Latch& latch) {
+    try {
+        slot.emplace(co_await std::move(task));
+    } catch (...) {
+        if (!failed.exchange(true, std::memory_order_relaxed)) {
+            error = std::current_exception(); // First failure only
+        }
+    }
+    latch.arrive();
+}
+
+template <typename... Ts, size_t... I>
+CoTask<std::tuple<Stored<Ts>...>> whenAllTuple(std::index_sequence<I...>, CoTask<Ts>... tasks) {
+    std::tuple<std::optional<Stored<Ts>>...> slots;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    Latch latch(sizeof...(Ts));
+    (runChild(storeResult(std::move(tasks)), std::get<I>(slots), error, failed, latch), ...);
+    co_await latch;
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    co_return std::tuple<Stored<Ts>...>(std::move(*std::get<I>(slots))...);
+}
+
+// Shared by the when_any awaiter and every child: whichever finishes first claims `winner`.
+template <typename T>
+struct AnyState {
+    std::atomic<bool> done{false};
+    std::coroutine_handle<> waiter;
+    size_t winner = 0;
+    std::optional<T> value;
+    std::exception_ptr error;
+    std::vector<CoTask<T>> tasks;
+};
+
+template <typename T>
+Detached runAnyChild(std::shared_ptr<AnyState<T>> state, size_t index, CoTask<T> task) {
+    std::optional<T> value;
+    std::exception_ptr error;
+    try {
+        value.emplace(co_await std::move(task));
+    } catch (...) {
+        error = std::current_exception();
+    }
+    if (!state->done.exchange(true, std::memory_order_acq_rel)) {
+        state->winner = index;
+        state->value = std::move(value);
+        state->error = error;
+        state->waiter.resume();
+    }
+}
+
+template <typename T>
+struct AnyAwaiter {
+    std::shared_ptr<AnyState<T>> state;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+        // A child may finish (and resume h) inside this loop: only locals are touched from here on.
+        std::shared_ptr<AnyState<T>> st = state;
+        st->waiter = h;
+        std::vector<CoTask<T>> tasks = std::move(st->tasks);
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            runAnyChild(st, i, std::move(tasks[i]));
+        }
+    }
+    std::pair<size_t, T> await_resume() {
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        return {state->winner, std::move(*state->value)};
+    }
+};
+
+} // namespace coro_detail
+
+// co_await schedule_on(pool): continue on one of the pool's workers.
+// A rejected enqueue (bounded queue, FullPolicy::Reject) resumes at once and throws TaskRejected.
+class ScheduleOn {
+private:
+    ThreadPool& pool;
+    bool rejected = false;
+
+public:
+    explicit ScheduleOn(ThreadPool& p) : pool(p) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h) {
+        // Once queued, a worker may resume (and finish) h before enqueue() even returns: don't touch `this`.
+        if (pool.enqueue([h] { h.resume(); })) {
+            return true;
+        }
+        rejected = true;
+        return false;
+    }
+    void await_resume() const {
+        if (rejected) {
+            throw TaskRejected();
+        }
+    }
+};
+
+inline ScheduleOn schedule_on(ThreadPool& pool) {
+    return ScheduleOn(pool);
+}
+
+// Run all tasks concurrently; the result is a tuple of their results (void -> std::monostate).
+// If any of them throws, the first exception is rethrown after all have finished.
+template <typename... Ts>
+CoTask<std::tuple<coro_detail::Stored<Ts>...>> when_all(CoTask<Ts>... tasks) {
+    return coro_detail::whenAllTuple(std::index_sequence_for<Ts...>{}, std::move(tasks)...);
+}
+
+// Same for a runtime number of tasks of one type.
+template <typename T>
+CoTask<std::vector<coro_detail::Stored<T>>> when_all(std::vector<CoTask<T>> tasks) {
+    using S = coro_detail::Stored<T>;
+    std::vector<std::optional<S>> slots(tasks.size());
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    coro_detail::Latch latch(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        coro_detail::runChild(coro_detail::storeResult(std::move(tasks[i])), slots[i], error, failed, latch);
+    }
+    co_await latch;
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    std::vector<S> results;
+    results.reserve(slots.size());
+    for (auto& s : slots) {
+        results.push_back(std::move(*s));
+    }
+    co_return results;
+}
+
+// Resume with (index, result) of the first task to finish, or rethrow its exception.
+// The rest keep running to completion in the background; their results are dropped.
+// Throws std::invalid_argument for an empty vector.
+template <typename T>
+CoTask<std::pair<size_t, coro_detail::Stored<T>>> when_any(std::vector<CoTask<T>> tasks) {
+    using S = coro_detail::Stored<T>;
+    if (tasks.empty()) {
+        throw std::invalid_argument("when_any needs at least one task");
+    }
+    auto state = std::make_shared<coro_detail::AnyState<S>>();
+    for (auto& t : tasks) {
+        state->tasks.push_back(coro_detail::storeResult(std::move(t)));
+    }
+    // A named awaiter: GCC 12 may destroy a temporary awaiter in a co_await expression twice.
+    coro_detail::AnyAwaiter<S> awaiter{std::move(state)};
+    co_return co_await awaiter;
+}
+
+namespace coro_detail {
+
+// Completion flag of sync_wait(). Set and notified under the mutex: once the waiter sees it, the
+// driver no longer touches it, so the waiter may return (and destroy it) right away.
+struct SyncSignal {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool done = false;
+};
+
+template <typename T>
+Detached syncDriver(CoTask<T>& task, std::optional<Stored<T>>& value, std::exception_ptr& error,
+                    SyncSignal& signal) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(task);
+            value.emplace();
+        } else {
+            value.emplace(co_await std::move(task));
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(signal.mtx);
+    signal.done = true;
+    signal.cv.notify_one();
+}
+
+} // namespace coro_detail
+
+// Block the calling thread until `task` finishes; return its result or rethrow its exception.
+// Not from inside a pool worker whose pool the task needs: that worker would wait for itself.
+template <typename T>
+T sync_wait(CoTask<T> task) {
+    std::optional<coro_detail::Stored<T>> value;
+    std::exception_ptr error;
+    coro_detail::SyncSignal signal;
+    coro_detail::syncDriver(task, value, error, signal);
+    {
+        std::unique_lock<std::mutex> lock(signal.mtx);
+        signal.cv.wait(lock, [&signal] { return signal.done; });
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*value);
+    }
+}
+
+#endif // CORO_TASK_HPP
@@ -0,0 +1,137 @@
+#ifndef CPU_TOPOLOGY_HPP
+#define CPU_TOPOLOGY_HPP
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// CPU Topology (which CPUs belong to which NUMA node) + thread pinning
+// Goal: Place threads next to the memory they use.
+// Mechanics:
+// 1. NUMA (Non-Uniform Memory Access): on a multi-socket machine each socket ("node") has its own
+//    memory. Reading another node's memory crosses the interconnect: slower, and it shares bandwidth.
+// 2. Linux publishes the layout in sysfs: /sys/devices/system/node/nodeN/cpulist ("0-15,32-47").
+//    Node ids can have gaps (offlined or hot-plugged nodes, some POWER/ARM layouts), so the ids come
+//    from node/online (a cpulist-format list of node ids; node/possible if that is missing).
+//    Only CPUs this process may run on (sched_getaffinity: cgroups, taskset) are kept.
+//    No sysfs (containers, other OSes) -> one node with every allowed CPU.
+// 3. pinCurrentThread(): pthread_setaffinity_np restricts a thread to a CPU set. The scheduler then
+//    stops migrating it, so its caches (and the memory it first-touched) stay local.
+// 4. First-touch policy: Linux places a page on the node of the thread that first WRITES it.
+//    Allocate and initialize data from a thread pinned to the node that will use it.
+
+// Parse a Linux cpulist ("0-3,8,10-11") into CPU ids.
+inline std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        if (last < first) {
+            throw std::invalid_argument("bad cpulist range: " + range);
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+struct CpuTopology {
+    std::vector<std::vector<int>> nodeCpus; // nodeCpus[node] = CPU ids on that node
+
+    size_t nodes() const { return nodeCpus.size(); }
+
+    size_t cpus() const {
+        size_t n = 0;
+        for (const auto& node : nodeCpus) n += node.size();
+        return n;
+    }
+
+    // `nodeDir` is the sysfs node directory (tests point it at a fake tree).
+    // nodeCpus is indexed densely: node ids with gaps still give nodeCpus[0..nodes()-1].
+    static CpuTopology detect(const std::string& nodeDir = "/sys/devices/system/node") {
+        std::vector<int> allowed = allowedCpus();
+        CpuTopology topo;
+        for (int node : nodeIds(nodeDir)) {
+            std::ifstream in(nodeDir + "/node" + std::to_string(node) + "/cpulist");
+            if (!in) continue;
+            std::string line;
+            std::getline(in, line);
+            std::vector<int> cpus;
+            for (int cpu : parseCpuList(line)) {
+                if (isAllowed(allowed, cpu)) cpus.push_back(cpu);
+            }
+            if (!cpus.empty()) {
+                topo.nodeCpus.push_back(std::move(cpus)); // Nodes without usable CPUs are skipped
+            }
+        }
+        if (topo.nodeCpus.empty()) {
+            topo.nodeCpus.push_back(allowed);
+        }
+        return topo;
+    }
+
+private:
+    static std::vector<int> nodeIds(const std::string& nodeDir) {
+        for (const char* file : {"/online", "/possible"}) {
+            std::ifstream in(nodeDir + file);
+            std::string line;
+            if (in && std::getline(in, line)) return parseCpuList(line);
+        }
+        return {};
+    }
+
+    static std::vector<int> allowedCpus() {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            unsigned n = std::thread::hardware_concurrency();
+            for (unsigned cpu = 0; cpu < (n ? n : 1); ++cpu) cpus.push_back(static_cast<int>(cpu));
+        }
+        return cpus;
+    }
+
+    static bool isAllowed(const std::vector<int>& allowed, int cpu) {
+        for (int a : allowed) {
+            if (a == cpu) return true;
+        }
+        return false;
+    }
+};
+
+// Restrict the calling thread to `cpus`. Returns false if the OS refused (or pinning is unsupported);
+// the thread then simply keeps running unpinned.
+inline bool pinCurrentThread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+#endif // CPU_TOPOLOGY_HPP
@@ -0,0 +1,137 @@
+#ifndef EXPIRING_LRU_CACHE_HPP
+#define EXPIRING_LRU_CACHE_HPP
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include "systemDesign/lruCache.hpp"
+#include "systemDesign/timerWheel.hpp"
+
+// Expiring LRU Cache (TTL)
+// Goal: An LRU cache whose entries also go stale after a time-to-live, without wrapping every value
+//       in a timestamp by hand.
+// Mechanics:
+// 1. Storage: an LRUCache<K, Entry> where Entry = {value, expiresAt}. Capacity still evicts by LRU.
+// 2. Lazy expiry: get() checks expiresAt. A stale entry is erased and reported as a miss.
+//    Correctness never depends on the reaper running.
+// 3. Active expiry (reap): every put() also schedules the key in a hierarchical TimerWheel.
+//    reap() advances the wheel to "now" and erases entries whose time has come, so memory held by
+//    expired-but-never-read entries is returned without scanning the whole list.
+//    - Timers are never cancelled. If a key was overwritten (new expiresAt) or already evicted,
+//      its old timer finds nothing to do when it fires. That keeps put() O(1).
+// 4. Bounded lock hold: reap(maxBatch) locks once and does at most maxBatch wheel steps.
+//    Run it periodically (e.g. from a background task) until it returns 0.
+// 5. Thread-safe: one mutex guards the cache and the wheel.
+// Clock is a template parameter so tests can drive time by hand.
+
+template <typename K, typename V, typename Clock = std::chrono::steady_clock>
+class ExpiringLRUCache {
+public:
+    using Duration = typename Clock::duration;
+    using TimePoint = typename Clock::time_point;
+
+private:
+    struct Entry {
+        V value;
+        TimePoint expiresAt;
+    };
+
+    mutable std::mutex mtx;
+    LRUCache<K, Entry> cache;
+    TimerWheel<K> wheel;
+    Duration defaultTtl;
+    Duration tickLength; // Reaping resolution
+    TimePoint epoch;     // Tick 0
+
+    // Round up, so the wheel never fires before the entry is really stale.
+    uint64_t tickFor(TimePoint t) const {
+        auto ticks = (t - epoch + tickLength - Duration(1)) / tickLength;
+        return ticks > 0 ? static_cast<uint64_t>(ticks) : 0;
+    }
+
+    uint64_t currentTick(TimePoint now) const {
+        auto ticks = (now - epoch) / tickLength;
+        return ticks > 0 ? static_cast<uint64_t>(ticks) : 0;
+    }
+
+public:
+    ExpiringLRUCache(size_t capacity, Duration ttl,
+                     Duration tick = std::chrono::duration_cast<Duration>(std::chrono::milliseconds(10)))
+        : cache(capacity), defaultTtl(ttl), tickLength(tick), epoch(Clock::now()) {
+        if (tick <= Duration::zero()) {
+            throw std::invalid_argument("ExpiringLRUCache tick must be positive");
+        }
+    }
+
+    // Insert or Update value with the default TTL.
+    void put(const K& key, const V& value) {
+        put(key, value, defaultTtl);
+    }
+
+    // Insert or Update value with its own TTL.
+    // Complexity: O(1)
+    void put(const K& key, const V& value, Duration ttl) {
+        TimePoint expiresAt = Clock::now() + ttl;
+        std::lock_guard<std::mutex> lock(mtx);
+        cache.put(key, Entry{value, expiresAt});
+        wheel.schedule(tickFor(expiresAt), key);
+    }
+
+    // Copy of the value, or std::nullopt if missing or expired (an expired entry is erased here).
+    // Marks a live entry as Recently Used.
+    std::optional<V> try_get(const K& key) {
+        TimePoint now = Clock::now();
+        std::lock_guard<std::mutex> lock(mtx);
+        const Entry* entry = cache.peek(key);
+        if (!entry) {
+            return std::nullopt;
+        }
+        if (entry->expiresAt <= now) {
+            cache.erase(key);
+            return std::nullopt;
+        }
+        return cache.try_get(key)->value;
+    }
+
+    // Get value by key. Throws std::runtime_error if missing or expired (same contract as LRUCache).
+    V get(const K& key) {
+        std::optional<V> value = try_get(key);
+        if (!value) {
+            throw std::runtime_error("Key not found");
+        }
+        return std::move(*value);
+    }
+
+    // Erase entries whose TTL has passed, doing at most maxBatch steps under the lock.
+    // Returns how many entries were erased. caughtUp() tells whether another call is needed.
+    size_t reap(size_t maxBatch = 1024) {
+        TimePoint now = Clock::now();
+        std::lock_guard<std::mutex> lock(mtx);
+        size_t erased = 0;
+        wheel.advance(currentTick(now), maxBatch, [&](const K& key) {
+            const Entry* entry = cache.peek(key);
+            // Stale timer: the key was overwritten with a later expiry, or is already gone.
+            if (entry && entry->expiresAt <= now) {
+                cache.erase(key);
+                ++erased;
+            }
+        });
+        return erased;
+    }
+
+    // True when the last reap() processed everything due up to now.
+    bool caughtUp() const {
+        TimePoint now = Clock::now();
+        std::lock_guard<std::mutex> lock(mtx);
+        return wheel.caughtUp(currentTick(now));
+    }
+
+    // Number of cached entries, including expired ones that were not read or reaped yet.
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return cache.size();
+    }
+};
+
+#endif // EXPIRING_LRU_CACHE_HPP
@@ -0,0 +1,119 @@
+#ifndef INLINE_TASK_HPP
+#define INLINE_TASK_HPP
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Inline Task (small-buffer, move-only void() callable)
+// Goal: Store a task in the queue without touching the heap.
+// Mechanics:
+// 1. Problem: std::function<void()> keeps only ~16 bytes of captures inline (libstdc++).
+//    A lambda capturing a few pointers and a size is already bigger -> one new on enqueue,
+//    one delete after the task runs. Two allocator round-trips per task.
+//    std::function must also be copyable, so move-only captures (unique_ptr, promises) don't fit.
+// 2. InlineTask<Capacity> has a Capacity-byte aligned buffer. A callable that fits is
+//    move-constructed straight into it. Bigger (or throwing-move) callables still work,
+//    they fall back to one heap allocation.
+// 3. Type erasure by a static table of 3 function pointers per callable type
+//    (invoke / relocate / destroy), instead of a virtual base class: one pointer per task.
+// 4. Move-only: moving a task relocates the callable (move + destroy source).
+
+template <size_t Capacity = 64>
+class InlineTask {
+private:
+    struct Ops {
+        void (*invoke)(void* self);
+        void (*relocate)(void* dst, void* src) noexcept; // Move src into dst, destroy src
+        void (*destroy)(void* self) noexcept;
+    };
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const Ops* ops = nullptr;
+
+    template <typename F>
+    static constexpr bool kFitsInline = sizeof(F) <= Capacity &&
+                                        alignof(F) <= alignof(std::max_align_t) &&
+                                        std::is_nothrow_move_constructible_v<F>;
+
+    // Callable lives in the buffer.
+    template <typename F>
+    static constexpr Ops kInlineOps = {
+        [](void* self) { (*static_cast<F*>(self))(); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        },
+        [](void* self) noexcept { static_cast<F*>(self)->~F(); },
+    };
+
+    // Buffer holds an F* to a heap copy.
+    template <typename F>
+    static constexpr Ops kHeapOps = {
+        [](void* self) { (**static_cast<F**>(self))(); },
+        [](void* dst, void* src) noexcept { *static_cast<F**>(dst) = *static_cast<F**>(src); },
+        [](void* self) noexcept { delete *static_cast<F**>(self); },
+    };
+
+    void reset() noexcept {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+public:
+    InlineTask() = default;
+
+    template <typename F, typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<D, InlineTask> && std::is_invocable_v<D&>>>
+    InlineTask(F&& f) {
+        if constexpr (kFitsInline<D>) {
+            ::new (static_cast<void*>(storage)) D(std::forward<F>(f));
+            ops = &kInlineOps<D>;
+        } else {
+            ::new (static_cast<void*>(storage)) D*(new D(std::forward<F>(f)));
+            ops = &kHeapOps<D>;
+        }
+    }
+
+    InlineTask(InlineTask&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->relocate(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    InlineTask& operator=(InlineTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) {
+                other.ops->relocate(storage, other.storage);
+                ops = std::exchange(other.ops, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    ~InlineTask() {
+        reset();
+    }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    void operator()() {
+        if (!ops) throw std::logic_error("empty InlineTask");
+        ops->invoke(storage);
+    }
+
+    // True if a callable of type F is stored without a heap allocation.
+    template <typename F>
+    static constexpr bool storesInline() { return kFitsInline<std::decay_t<F>>; }
+};
+
+#endif // INLINE_TASK_HPP
@@ -1,10 +1,16 @@
 #ifndef LRU_CACHE_HPP
 #define LRU_CACHE_HPP
 
+#include <algorithm>
+#include <iterator>
 #include <list>
+#include <span>
 #include <unordered_map>
 #include <stdexcept>
 #include <iostream>
+#include <tuple>
+#include <utility>
+#include "systemDesign/cacheStats.hpp"
 
 // LRU Cache (Least Recently Used)
 // Goal: A fixed-size cache that evicts the least recently accessed item when full.
@@ -15,65 +21,353 @@
 //    - Tail = Least Recently Used.
 // 2. Hash Map (std::unordered_map): Maps Keys to Iterators (pointers) in the list.
 //    - Why? O(1) lookup. Without this, finding an item in the list would be O(N).
+// 3. Weigher (optional): Capacity is a budget of "weight", not a number of entries.
+//    - Default UnitWeigher: every entry weighs 1, so capacity = max number of entries (classic LRU).
+//    - Byte budget: pass a weigher returning the entry's size in bytes, e.g.
+//      struct Bytes { size_t operator()(const std::string& k, const std::string& v) const {
+//          return k.size() + v.size(); } };
+//      LRUCache<std::string, std::string, Bytes> cache(64 << 20); // 64 MB budget
+//    - put() evicts from the tail until the total weight fits the budget again.
+// 4. Stats (optional, CollectStats = true): hit/miss/insert/update/eviction counters and a sampled
+//    get/put latency histogram, read with stats(). With the default (false) they compile to nothing.
+//      LRUCache<int, std::string, UnitWeigher, true> cache(1000);
+//      cache.sampleLatencyEvery(64);
+//      double ratio = cache.stats().hitRatio();
+// 5. Batch API (get_many / put_many): look up a whole batch of keys before touching any of them.
+//    A loop of get() stalls on one cache miss at a time (hash bucket -> map node -> list node).
+//    Doing all the hash-map finds first and prefetching their list nodes keeps many memory loads
+//    in flight at once, which matters once the cache is much larger than the CPU's LLC.
 
-template <typename K, typename V>
+// Every entry costs 1 -> capacity counts entries.
+struct UnitWeigher {
+    template <typename K, typename V>
+    size_t operator()(const K&, const V&) const {
+        return 1;
+    }
+};
+
+template <typename K, typename V, typename Weigher = UnitWeigher, bool CollectStats = false>
 class LRUCache {
 private:
-    size_t capacity;
-    std::list<std::pair<K, V>> items; // Doubly Linked List of {Key, Value}
-    std::unordered_map<K, typename std::list<std::pair<K, V>>::iterator> lookup; // Key -> Iterator
+    using List = std::list<std::pair<K, V>>;
+
+    // The weight is stored, not recomputed: eviction must subtract exactly what insertion added.
+    struct Slot {
+        typename List::iterator it;
+        size_t weight;
+    };
+
+    size_t capacity; // Weight budget (= max entries with UnitWeigher)
+    size_t totalWeight = 0;
+    size_t evictionCount = 0;
+    size_t evictedWeightTotal = 0;
+    List items; // Doubly Linked List of {Key, Value}
+    std::unordered_map<K, Slot> lookup; // Key -> Iterator (+ weight)
+    Weigher weigher;
+    [[no_unique_address]] CacheStats<CollectStats> counters; // Zero bytes when stats are off
+
+    // Remove the LRU entry (Back of list).
+    // Take a reference, not a copy: a copy of items.back() would duplicate a possibly huge value
+    // just to read its key.
+    void evictLRU() {
+        const auto& lru = items.back();
+        auto it = lookup.find(lru.first);
+        totalWeight -= it->second.weight;
+        evictedWeightTotal += it->second.weight;
+        ++evictionCount;
+        counters.eviction();
+        lookup.erase(it);  // Remove from map
+        items.pop_back();  // Remove from list
+    }
+
+    // Evict from the tail until the budget fits. The MRU entry (the one just written) is never
+    // evicted: an entry heavier than the whole budget ends up cached alone.
+    void trimToBudget() {
+        while (totalWeight > capacity && items.size() > 1) {
+            evictLRU();
+        }
+    }
+
+    // Keys per batch pass: enough loads in flight to hide memory latency, few enough that the
+    // prefetched lines are still in L1 when the second pass uses them.
+    static constexpr size_t kBatchChunk = 16;
+
+    static void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p, 1 /* will write (splice) */, 3 /* keep in all cache levels */);
+#else
+        (void)p;
+#endif
+    }
+
+    // Move an existing entry to the front, overwrite its value and re-weigh it.
+    template <typename U>
+    V& update(Slot& slot, U&& value) {
+        counters.update();
+        items.splice(items.begin(), items, slot.it);
+        slot.it->second = std::forward<U>(value);
+        totalWeight -= slot.weight;
+        slot.weight = weigher(slot.it->first, slot.it->second);
+        totalWeight += slot.weight;
+        trimToBudget();
+        return slot.it->second;
+    }
+
+    // Insert a key that is known to be absent. Builds the value in place at the front of the list.
+    // piecewise_construct forwards the key and the value's constructor arguments separately,
+    // so nothing is copied or moved twice.
+    template <typename KK, typename... Args>
+    V& insertNew(KK&& key, Args&&... args) {
+        counters.insert();
+        items.emplace_front(std::piecewise_construct,
+                            std::forward_as_tuple(std::forward<KK>(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        size_t w = weigher(items.front().first, items.front().second);
+        lookup.emplace(items.front().first, Slot{items.begin(), w});
+        totalWeight += w;
+        trimToBudget(); // Evicts LRU entries if full
+        return items.front().second;
+    }
 
 public:
     LRUCache(size_t cap) : capacity(cap) {}
 
+    // Non-throwing lookup
+    // Returns a pointer to the cached value (marked as Recently Used), or nullptr on a miss.
+    // No exception on a miss and no copy on a hit.
+    // The pointer stays valid until the entry is evicted; the next put() may do that.
+    // Complexity: O(1)
+    V* try_get(const K& key) {
+        [[maybe_unused]] auto sample = counters.sampleGet();
+        auto it = lookup.find(key);
+        if (it == lookup.end()) {
+            counters.miss();
+            return nullptr;
+        }
+        counters.hit();
+        items.splice(items.begin(), items, it->second.it);
+        return &it->second.it->second;
+    }
+
+    // Lookup WITHOUT marking the entry as Recently Used (e.g. for housekeeping that must not
+    // disturb the eviction order). nullptr on a miss.
+    // Complexity: O(1)
+    const V* peek(const K& key) const {
+        auto it = lookup.find(key);
+        return it == lookup.end() ? nullptr : &it->second.it->second;
+    }
+
     // Get value by key
+    // Throws std::runtime_error on a miss. Prefer try_get() where misses are common:
+    // throwing costs microseconds, and this returns a copy of the value.
     // Complexity: O(1)
     V get(const K& key) {
+        [[maybe_unused]] auto sample = counters.sampleGet();
         auto it = lookup.find(key);
         if (it == lookup.end()) {
+            counters.miss();
             throw std::runtime_error("Key not found");
         }
+        counters.hit();
         
         // 1. Move accessed item to the front of list (Mark as Recently Used)
         // splice() moves an element from one list position to another in O(1) without copying.
-        items.splice(items.begin(), items, it->second);
+        items.splice(items.begin(), items, it->second.it);
         
         // 2. Return value
-        return it->second->second;
+        return it->second.it->second;
+    }
+
+    // Batch lookup
+    // results[i] = pointer to the value of keys[i] (marked as Recently Used), or nullptr on a miss.
+    // Same effect as calling try_get() on each key in order: later keys end up more recent.
+    // Pass 1 finds a chunk of keys and prefetches their list nodes; pass 2 splices and reads them.
+    // Pass 2 never erases, so the iterators from pass 1 stay valid.
+    void get_many(std::span<const K> keys, std::span<V*> results) {
+        if (results.size() < keys.size()) {
+            throw std::invalid_argument("get_many: results span is smaller than keys");
+        }
+        typename std::unordered_map<K, Slot>::iterator found[kBatchChunk];
+        for (size_t base = 0; base < keys.size(); base += kBatchChunk) {
+            size_t n = std::min(kBatchChunk, keys.size() - base);
+
+            // Pass 1: independent finds (no stores in between, so the CPU overlaps their misses)
+            for (size_t i = 0; i < n; ++i) {
+                found[i] = lookup.find(keys[base + i]);
+                if (found[i] != lookup.end()) {
+                    prefetch(&*found[i]->second.it);
+                }
+            }
+
+            // Pass 2: resolve in order
+            for (size_t i = 0; i < n; ++i) {
+                if (found[i] == lookup.end()) {
+                    counters.miss();
+                    results[base + i] = nullptr;
+                    continue;
+                }
+                counters.hit();
+                items.splice(items.begin(), items, found[i]->second.it);
+                results[base + i] = &found[i]->second.it->second;
+            }
+        }
+    }
+
+    // Batch insert/update: same effect as put(keys[i], values[i]) in order.
+    // Pass 1 only warms the cache (find + prefetch); pass 2 calls put(). Iterators are not carried
+    // over because an eviction in pass 2 could invalidate them. The second find hits warm lines.
+    void put_many(std::span<const K> keys, std::span<const V> values) {
+        if (values.size() < keys.size()) {
+            throw std::invalid_argument("put_many: values span is smaller than keys");
+        }
+        for (size_t base = 0; base < keys.size(); base += kBatchChunk) {
+            size_t n = std::min(kBatchChunk, keys.size() - base);
+            for (size_t i = 0; i < n; ++i) {
+                auto it = lookup.find(keys[base + i]);
+                if (it != lookup.end()) {
+                    prefetch(&*it->second.it);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                put(keys[base + i], values[base + i]);
+            }
+        }
+    }
+
+    // Read-through lookup
+    // On a hit returns the cached value. On a miss calls loader(key), caches the result and returns it.
+    // If loader throws, the cache is left unchanged.
+    // Complexity: O(1) + cost of loader on a miss
+    template <typename F>
+    V& get_or_compute(const K& key, F&& loader) {
+        if (V* cached = try_get(key)) {
+            return *cached;
+        }
+        return insertNew(key, std::forward<F>(loader)(key));
     }
 
     // Insert or Update value
     // Complexity: O(1)
     void put(const K& key, const V& value) {
+        [[maybe_unused]] auto sample = counters.samplePut();
         auto it = lookup.find(key);
         
         // Case 1: Update existing key
+        // Moves it to front, updates the value and re-weighs it (a bigger value may evict others)
         if (it != lookup.end()) {
-            // Move key to front
-            items.splice(items.begin(), items, it->second);
-            // Update value
-            it->second->second = value;
+            update(it->second, value);
             return;
         }
 
-        // Case 2: Insert new key
-        // If cache is full, evict LRU (Back of list)
-        if (items.size() == capacity) {
-            auto lru = items.back(); // Last item
-            lookup.erase(lru.first); // Remove from map
-            items.pop_back();        // Remove from list
+        // Case 2: Insert new key (evicts LRU if full)
+        insertNew(key, value);
+    }
+
+    // Insert or Update value, moving the key and value into the cache instead of copying.
+    // Complexity: O(1)
+    void put(K&& key, V&& value) {
+        [[maybe_unused]] auto sample = counters.samplePut();
+        auto it = lookup.find(key);
+        if (it != lookup.end()) {
+            update(it->second, std::move(value));
+            return;
         }
+        insertNew(std::move(key), std::move(value));
+    }
 
-        // Add new item to front of list
-        items.push_front({key, value});
-        // Update map
-        lookup[key] = items.begin();
+    // Insert or Update, constructing the value in place from args (no temporary V).
+    // Returns a reference to the stored value.
+    // Complexity: O(1)
+    template <typename... Args>
+    V& emplace(const K& key, Args&&... args) {
+        [[maybe_unused]] auto sample = counters.samplePut();
+        auto it = lookup.find(key);
+        if (it != lookup.end()) {
+            return update(it->second, V(std::forward<Args>(args)...));
+        }
+        return insertNew(key, std::forward<Args>(args)...);
     }
     
+    // Remove a key. Returns false if it was not cached. Not counted as an eviction.
+    // Complexity: O(1)
+    bool erase(const K& key) {
+        auto it = lookup.find(key);
+        if (it == lookup.end()) {
+            return false;
+        }
+        totalWeight -= it->second.weight;
+        items.erase(it->second.it);
+        lookup.erase(it);
+        return true;
+    }
+
+    // Visit every entry from MRU to LRU without changing the order. f(key, value).
+    template <typename F>
+    void for_each(F&& f) const {
+        for (const auto& kv : items) {
+            f(kv.first, kv.second);
+        }
+    }
+
+    // Bulk restore (warm start, see lruSnapshot.hpp)
+    // reserve() sizes the hash map once, so a large restore never rehashes.
+    // append_lru() adds an entry at the LRU end: feeding entries in MRU->LRU order rebuilds the
+    // original recency order. No find/splice/evict per entry, unlike put().
+    // Returns false (and stores nothing) if the key is already cached or the budget is full.
+    void reserve(size_t n) {
+        lookup.reserve(n);
+    }
+
+    bool append_lru(K&& key, V&& value) {
+        size_t w = weigher(key, value);
+        if (totalWeight + w > capacity) {
+            return false;
+        }
+        items.emplace_back(std::move(key), std::move(value));
+        if (!lookup.try_emplace(items.back().first, Slot{std::prev(items.end()), w}).second) {
+            items.pop_back(); // Duplicate key in the input: keep the first (more recent) one
+            return false;
+        }
+        totalWeight += w;
+        return true;
+    }
+
     // Helper for debugging/testing
     size_t size() const {
         return items.size();
     }
+
+    // Weight budget given to the constructor (= max entries with UnitWeigher).
+    size_t maxWeight() const {
+        return capacity;
+    }
+
+    // Sum of the weights of all cached entries (== size() with UnitWeigher).
+    // Weights are taken at put() time: mutating a value through try_get() does not re-weigh it.
+    size_t weight() const {
+        return totalWeight;
+    }
+
+    // Number of entries evicted to stay within the budget (updates and misses do not count).
+    size_t evictions() const {
+        return evictionCount;
+    }
+
+    // Total weight reclaimed by those evictions.
+    size_t evictedWeight() const {
+        return evictedWeightTotal;
+    }
+
+    // Counters + latency histograms. All zeros unless CollectStats is true.
+    // Safe to call from another thread while the cache is in use (relaxed atomics).
+    CacheStatsSnapshot stats() const {
+        return counters.snapshot();
+    }
+
+    // Time 1 in n get/put calls into the latency histograms (0 = off, the default).
+    void sampleLatencyEvery(uint32_t n) {
+        counters.sampleLatencyEvery(n);
+    }
 };
 
 #endif // LRU_CACHE_HPP
@@ -0,0 +1,264 @@
+#ifndef LRU_SNAPSHOT_HPP
+#define LRU_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "systemDesign/lruCache.hpp"
+
+// LRU Snapshot (Persist + Warm Start)
+// Goal: After a restart, start with yesterday's hot set instead of a cold cache
+//       (a cold cache sends a "thundering herd" of misses to the backends).
+// Mechanics:
+// 1. saveSnapshot(): writes every entry in recency order (MRU first) to a compact binary file.
+//    - Written to "<path>.tmp" then rename()d: a crash mid-write never leaves a half file behind.
+// 2. loadSnapshot(): mmap()s the file and decodes straight from the mapped pages.
+//    - mmap: the kernel maps the file into our address space, no read() copies into a buffer.
+//    - All entries are decoded into a staging vector first: a corrupt entry anywhere in the file throws
+//      before the cache is touched, so a failed load leaves the cache exactly as it was.
+//    - The cache's hash map is reserved once, then entries are appended at the LRU end
+//      (LRUCache::append_lru). No put() per entry, so no per-entry find/splice/evict or rehashing.
+//    - Because the file is MRU-first, a smaller cache keeps the hottest entries and drops the tail.
+//      With UnitWeigher, decoding stops once there is an entry for every free slot.
+//    - The entry count in the header is not trusted: a count that cannot fit in the rest of the file
+//      (count x smallest possible entry) is rejected, and at most the cache's budget is reserved.
+// 3. Serializers are pluggable: SnapshotSerializer<T> handles trivially-copyable types (raw bytes)
+//    and std::string (length + bytes). Specialize it, or pass your own, for other types.
+// File layout: [magic "LRUSNAP1"][u64 count] then `count` x [key bytes][value bytes].
+// Raw bytes use the host's endianness and layout: snapshots are for restarting on the same platform.
+
+// Buffered binary writer on top of FILE*.
+class SnapshotWriter {
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+
+public:
+    explicit SnapshotWriter(std::FILE* f) : file(f) {
+        buffer.reserve(1 << 20);
+    }
+
+    void write(const void* data, size_t n) {
+        if (buffer.size() + n > buffer.capacity()) {
+            flush();
+        }
+        if (n > buffer.capacity()) {
+            if (std::fwrite(data, 1, n, file) != n) throw std::runtime_error("snapshot write failed");
+            return;
+        }
+        const char* p = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), p, p + n);
+    }
+
+    void flush() {
+        if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+            throw std::runtime_error("snapshot write failed");
+        }
+        buffer.clear();
+    }
+};
+
+// Bounds-checked cursor over the mapped file. A truncated or corrupt file throws, never over-reads.
+class SnapshotReader {
+private:
+    const char* cursor;
+    const char* end;
+
+public:
+    SnapshotReader(const char* begin, size_t size) : cursor(begin), end(begin + size) {}
+
+    // Returns a pointer to the next n bytes and advances past them.
+    const char* take(size_t n) {
+        if (static_cast<size_t>(end - cursor) < n) {
+            throw std::runtime_error("snapshot is truncated or corrupt");
+        }
+        const char* p = cursor;
+        cursor += n;
+        return p;
+    }
+
+    size_t remaining() const {
+        return static_cast<size_t>(end - cursor);
+    }
+
+    void read(void* out, size_t n) {
+        std::memcpy(out, take(n), n); // memcpy: the mapped bytes are not aligned for T
+    }
+};
+
+// Default serializer: no specialization for this type.
+template <typename T, typename Enable = void>
+struct SnapshotSerializer {
+    static_assert(sizeof(T) == 0, "No SnapshotSerializer for this type: specialize SnapshotSerializer<T> "
+                                  "with write(SnapshotWriter&, const T&) and read(SnapshotReader&)");
+};
+
+// Trivially copyable (int, double, POD structs): raw bytes.
+template <typename T>
+struct SnapshotSerializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+    static constexpr size_t kMinBytes = sizeof(T); // Smallest encoding: bounds the header's entry count
+    static void write(SnapshotWriter& out, const T& v) {
+        out.write(&v, sizeof(T));
+    }
+    static T read(SnapshotReader& in) {
+        T v;
+        in.read(&v, sizeof(T));
+        return v;
+    }
+};
+
+// std::string: u32 length followed by the characters.
+template <>
+struct SnapshotSerializer<std::string> {
+    static constexpr size_t kMinBytes = sizeof(uint32_t);
+    static void write(SnapshotWriter& out, const std::string& s) {
+        uint32_t n = static_cast<uint32_t>(s.size());
+        out.write(&n, sizeof(n));
+        out.write(s.data(), n);
+    }
+    static std::string read(SnapshotReader& in) {
+        uint32_t n;
+        in.read(&n, sizeof(n));
+        return std::string(in.take(n), n);
+    }
+};
+
+// Ser::kMinBytes if the serializer declares it, else 0 (no bound on the entry count from this side).
+template <typename Ser, typename = void>
+struct SnapshotMinBytes : std::integral_constant<size_t, 0> {};
+
+template <typename Ser>
+struct SnapshotMinBytes<Ser, std::void_t<decltype(Ser::kMinBytes)>> : std::integral_constant<size_t, Ser::kMinBytes> {};
+
+// RAII read-only memory mapping of a whole file.
+class MappedFile {
+private:
+    void* data = MAP_FAILED;
+    size_t length = 0;
+
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open snapshot " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat snapshot " + path);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd); // The mapping stays valid after the descriptor is closed
+        if (length > 0 && data == MAP_FAILED) {
+            throw std::runtime_error("cannot mmap snapshot " + path);
+        }
+        if (length > 0) {
+            ::madvise(data, length, MADV_SEQUENTIAL); // We read front to back: read ahead aggressively
+        }
+    }
+
+    ~MappedFile() {
+        if (data != MAP_FAILED) {
+            ::munmap(data, length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* bytes() const { return length > 0 ? static_cast<const char*>(data) : nullptr; }
+    size_t size() const { return length; }
+};
+
+inline constexpr char kSnapshotMagic[8] = {'L', 'R', 'U', 'S', 'N', 'A', 'P', '1'};
+
+// Write all entries of `cache` (MRU first) to `path`. Returns the number of entries written.
+template <typename KSer = void, typename VSer = void, typename K, typename V, typename W, bool S>
+size_t saveSnapshot(const LRUCache<K, V, W, S>& cache, const std::string& path) {
+    using KS = std::conditional_t<std::is_void_v<KSer>, SnapshotSerializer<K>, KSer>;
+    using VS = std::conditional_t<std::is_void_v<VSer>, SnapshotSerializer<V>, VSer>;
+
+    std::string tmp = path + ".tmp";
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        throw std::runtime_error("cannot create snapshot " + tmp);
+    }
+    try {
+        SnapshotWriter out(f);
+        uint64_t count = cache.size();
+        out.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+        out.write(&count, sizeof(count));
+        cache.for_each([&out](const K& key, const V& value) {
+            KS::write(out, key);
+            VS::write(out, value);
+        });
+        out.flush();
+    } catch (...) {
+        std::fclose(f);
+        std::remove(tmp.c_str());
+        throw;
+    }
+    if (std::fclose(f) != 0 || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("cannot finalize snapshot " + path);
+    }
+    return cache.size();
+}
+
+// Warm-start `cache` from a snapshot written by saveSnapshot().
+// Entries are appended behind whatever the cache already holds (normally: load into an empty cache).
+// Once the cache's budget is full the remaining (coldest) entries are skipped.
+// Returns the number of entries loaded. Throws std::runtime_error on a missing or corrupt file;
+// nothing is loaded then (the whole file is decoded before the first entry goes into the cache).
+template <typename KSer = void, typename VSer = void, typename K, typename V, typename W, bool S>
+size_t loadSnapshot(LRUCache<K, V, W, S>& cache, const std::string& path) {
+    using KS = std::conditional_t<std::is_void_v<KSer>, SnapshotSerializer<K>, KSer>;
+    using VS = std::conditional_t<std::is_void_v<VSer>, SnapshotSerializer<V>, VSer>;
+
+    MappedFile file(path);
+    SnapshotReader in(file.bytes(), file.size());
+    if (std::memcmp(in.take(sizeof(kSnapshotMagic)), kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        throw std::runtime_error("not an LRU snapshot: " + path);
+    }
+    uint64_t count;
+    in.read(&count, sizeof(count));
+    constexpr size_t minEntry = SnapshotMinBytes<KS>::value + SnapshotMinBytes<VS>::value;
+    if (minEntry > 0 && count > in.remaining() / minEntry) {
+        throw std::runtime_error("snapshot is truncated or corrupt: entry count does not fit the file");
+    }
+
+    constexpr bool unitWeight = std::is_same_v<W, UnitWeigher>;
+    size_t room = cache.maxWeight() - std::min(cache.weight(), cache.maxWeight());
+    uint64_t wanted = unitWeight ? std::min<uint64_t>(count, room) : count; // The rest would all be dropped
+    std::vector<std::pair<K, V>> staged;
+    staged.reserve(static_cast<size_t>(std::min<uint64_t>(wanted, room)));
+    for (uint64_t i = 0; i < wanted; ++i) {
+        K key = KS::read(in);
+        V value = VS::read(in);
+        staged.emplace_back(std::move(key), std::move(value));
+    }
+
+    cache.reserve(cache.size() + staged.size());
+    size_t loaded = 0;
+    for (auto& [key, value] : staged) {
+        if (cache.append_lru(std::move(key), std::move(value))) {
+            ++loaded;
+        }
+    }
+    return loaded;
+}
+
+#endif // LRU_SNAPSHOT_HPP
@@ -0,0 +1,128 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Bounded MPMC Queue (lock-free ring buffer, Dmitry Vyukov's design)
+// Goal: A fixed-size FIFO that many threads push to and pop from without a mutex,
+//       and that says "full" instead of growing until the process runs out of memory.
+// Mechanics:
+// 1. A power-of-two array of cells. Each cell has a sequence number next to its value.
+//    The sequence number says whose turn the cell is:
+//    - seq == pos      : empty, the producer that claims ticket `pos` may write it.
+//    - seq == pos + 1  : full, the consumer that claims ticket `pos` may read it.
+//    - After reading, the consumer sets seq = pos + capacity: empty for the next lap.
+// 2. Producers claim tickets with a CAS on enqueuePos, consumers with a CAS on dequeuePos.
+//    Different producers write different cells, so they only contend on that one counter.
+// 3. Full / empty are detected from the cell's seq (it lags a whole lap behind): no shared size counter.
+// 4. enqueuePos and dequeuePos sit on their own cache lines (producers vs consumers).
+// Any move-constructible T works: the seq store (release) publishes the value, the seq load
+// (acquire) makes it visible to the thread that reads it.
+
+template <typename T>
+class MPMCQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+
+    static size_t roundUp(size_t n) {
+        if (n < 2) {
+            throw std::invalid_argument("MPMCQueue capacity must be at least 2");
+        }
+        size_t cap = 1;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+public:
+    explicit MPMCQueue(size_t capacity) : mask(roundUp(capacity) - 1), cells(new Cell[mask + 1]) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    ~MPMCQueue() {
+        for (size_t pos = dequeuePos.load(); pos != enqueuePos.load(); ++pos) {
+            cells[pos & mask].value()->~T();
+        }
+    }
+
+    // Returns false (and leaves `v` untouched) if the queue is full.
+    bool try_push(T&& v) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break; // Ticket `pos` is ours
+                }
+            } else if (diff < 0) {
+                return false; // Cell still holds last lap's value: full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed); // Another producer got it
+            }
+        }
+        ::new (static_cast<void*>(cell->storage)) T(std::move(v));
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false if the queue is empty.
+    bool try_pop(T& out) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Not written yet: empty
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        T* value = cell->value();
+        out = std::move(*value);
+        value->~T();
+        cell->seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Approximate (racy) size: claimed tickets, some may still be in the middle of a push/pop.
+    size_t sizeApprox() const {
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool emptyApprox() const { return sizeApprox() == 0; }
+};
+
+#endif // MPMC_QUEUE_HPP
@@ -0,0 +1,152 @@
+#ifndef PARALLEL_ALGORITHMS_HPP
+#define PARALLEL_ALGORITHMS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "systemDesign/threadPool.hpp"
+
+// Parallel Algorithms over a ThreadPool (parallel_for / reduce / transform / inclusive_scan)
+// Goal: Stop hand-rolling chunking loops. Split the range, run the pieces on the pool, combine.
+// Mechanics:
+// 1. Recursive splitting: a range bigger than one leaf is cut in half. The right half becomes a
+//    TaskGroup task, the caller keeps the left half and recurses, then join()s (helping while it waits).
+//    Halves that nobody steals just run on the same thread: no more tasks are queued than idle workers can take.
+// 2. Leaf size: the range is cut into at most 8 leaves per worker slot (pool.capacity()). Enough leaves
+//    to even out uneven work, few enough that each leaf is much bigger than one task's overhead (~1 us).
+//    `grain` (0 = none) is a minimum leaf size on top of that, for cheap elements on short ranges.
+//    The cap also bounds how deep helping joins can nest (a join runs other leaves on its own stack):
+//    with one leaf per element, a 100k-element range would overflow a worker's stack.
+// 3. Same results as the serial algorithm:
+//    - parallel_for / parallel_transform: each index is visited once; only the order differs.
+//    - parallel_reduce / parallel_inclusive_scan: elements are combined left to right inside a leaf and
+//      leaves in range order, so any associative op (+ on integers, min, max, string concatenation)
+//      gives exactly the serial result. Floating-point + is not associative: the result depends on the
+//      leaf boundaries, so it is reproducible for one pool capacity and grain but may differ from
+//      std::accumulate in the last bits.
+// 4. Scan in two passes: (a) scan every chunk on its own, in parallel; (b) prefix the chunk totals
+//    serially (one value per chunk); (c) fold each chunk's carry into its elements, in parallel.
+// 5. Exceptions thrown by the callable propagate to the caller (first one wins), after every started
+//    piece has finished.
+// Safe to call from inside a pool task (nested parallelism): joins help instead of blocking.
+
+namespace parallel_detail {
+
+// Elements per leaf for n elements: at most kLeavesPerWorker * capacity() leaves, each >= grain.
+constexpr size_t kLeavesPerWorker = 8;
+
+inline size_t leafSize(const ThreadPool& pool, size_t n, size_t grain) {
+    size_t leaves = kLeavesPerWorker * std::max<size_t>(1, pool.capacity());
+    return std::max({size_t{1}, grain, (n + leaves - 1) / leaves});
+}
+
+// Call leaf(lo, hi) on pieces of [lo, hi) no bigger than `grain` (the leaf size), in parallel.
+template <typename Leaf>
+void split(ThreadPool& pool, size_t lo, size_t hi, size_t grain, const Leaf& leaf) {
+    if (hi - lo <= grain) {
+        leaf(lo, hi);
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    TaskGroup group(pool);
+    group.run([&pool, mid, hi, grain, &leaf] { split(pool, mid, hi, grain, leaf); });
+    split(pool, lo, mid, grain, leaf);
+    group.join();
+}
+
+// Reduce [lo, hi) to one value (non-empty range): leaves combine left to right, halves left then right.
+template <typename T, typename LeafReduce, typename Op>
+T reduceSplit(ThreadPool& pool, size_t lo, size_t hi, size_t grain, const LeafReduce& leaf, const Op& op) {
+    if (hi - lo <= grain) {
+        return leaf(lo, hi);
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    std::optional<T> right;
+    TaskGroup group(pool);
+    group.run([&] { right.emplace(reduceSplit<T>(pool, mid, hi, grain, leaf, op)); });
+    T left = reduceSplit<T>(pool, lo, mid, grain, leaf, op);
+    group.join();
+    return op(std::move(left), std::move(*right));
+}
+
+} // namespace parallel_detail
+
+// f(i) for every i in [first, last). grain: minimum indices per task (0 = automatic).
+template <typename Index, typename F>
+void parallel_for(ThreadPool& pool, Index first, Index last, F&& f, size_t grain = 0) {
+    if (!(first < last)) return;
+    size_t n = static_cast<size_t>(last - first);
+    grain = parallel_detail::leafSize(pool, n, grain);
+    parallel_detail::split(pool, 0, n, grain, [&f, first](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            f(static_cast<Index>(first + i));
+        }
+    });
+}
+
+// init op x0 op x1 op ... over [first, last) (like std::accumulate, but op must be associative).
+template <typename It, typename T, typename Op>
+T parallel_reduce(ThreadPool& pool, It first, It last, T init, Op op, size_t grain = 0) {
+    size_t n = static_cast<size_t>(std::distance(first, last));
+    if (n == 0) return init;
+    grain = parallel_detail::leafSize(pool, n, grain);
+    auto leaf = [first, &op](size_t lo, size_t hi) {
+        T acc = first[lo];
+        for (size_t i = lo + 1; i < hi; ++i) {
+            acc = op(std::move(acc), first[i]);
+        }
+        return acc;
+    };
+    return op(std::move(init), parallel_detail::reduceSplit<T>(pool, 0, n, grain, leaf, op));
+}
+
+// out[i] = f(first[i]) (like std::transform). Returns the end of the output range.
+template <typename It, typename Out, typename F>
+Out parallel_transform(ThreadPool& pool, It first, It last, Out out, F f, size_t grain = 0) {
+    size_t n = static_cast<size_t>(std::distance(first, last));
+    parallel_for(pool, size_t{0}, n, [&](size_t i) { out[i] = f(first[i]); }, grain);
+    return out + n;
+}
+
+// out[i] = first[0] op ... op first[i] (like std::inclusive_scan; op must be associative).
+// out may be first (in place). Returns the end of the output range.
+template <typename It, typename Out, typename Op>
+Out parallel_inclusive_scan(ThreadPool& pool, It first, It last, Out out, Op op, size_t grain = 0) {
+    using T = typename std::iterator_traits<Out>::value_type;
+    size_t n = static_cast<size_t>(std::distance(first, last));
+    if (n == 0) return out;
+    grain = parallel_detail::leafSize(pool, n, grain);
+    size_t chunks = (n + grain - 1) / grain;
+
+    // (a) Scan each chunk on its own.
+    parallel_for(pool, size_t{0}, chunks, [&](size_t c) {
+        size_t lo = c * grain, hi = std::min(n, lo + grain);
+        out[lo] = first[lo];
+        for (size_t i = lo + 1; i < hi; ++i) {
+            out[i] = op(out[i - 1], first[i]);
+        }
+    }, 1);
+    if (chunks == 1) return out + n;
+
+    // (b) carry[c - 1] = everything before chunk c. Built by push_back: T need not be default-constructible.
+    std::vector<T> carry;
+    carry.reserve(chunks - 1);
+    carry.push_back(out[grain - 1]);
+    for (size_t c = 2; c < chunks; ++c) {
+        carry.push_back(op(carry.back(), out[c * grain - 1]));
+    }
+
+    // (c) Fold the carry into chunks 1..chunks-1.
+    parallel_for(pool, size_t{1}, chunks, [&](size_t c) {
+        size_t lo = c * grain, hi = std::min(n, lo + grain);
+        for (size_t i = lo; i < hi; ++i) {
+            out[i] = op(carry[c - 1], out[i]);
+        }
+    }, 1);
+    return out + n;
+}
+
+#endif // PARALLEL_ALGORITHMS_HPP
@@ -0,0 +1,67 @@
+#ifndef POLICY_CACHE_HPP
+#define POLICY_CACHE_HPP
+
+#include <stdexcept>
+#include "systemDesign/cachePolicies.hpp"
+
+// Policy Cache (Compile-time pluggable eviction/admission)
+// Goal: One cache front-end, many replacement algorithms, zero virtual calls.
+// Mechanics:
+// 1. The policy is a template template parameter, e.g. PolicyCache<int, std::string, TinyLFUPolicy>.
+//    This is the Strategy pattern (see strategyPattern.hpp) resolved at compile time:
+//    the compiler inlines the policy, there is no vtable lookup on the hot path.
+// 2. The policy owns the storage (list segments + hash map) and decides who is evicted or admitted.
+//    The cache only provides the public get/put surface.
+// Available policies (cachePolicies.hpp): LRUPolicy (default), SLRUPolicy, TinyLFUPolicy.
+// Example usage:
+//   PolicyCache<int, std::string, SLRUPolicy> cache(1000);
+//   cache.put(1, "One");
+//   if (auto* v = cache.try_get(1)) { ... }
+
+template <typename K, typename V, template <typename, typename> class Policy = LRUPolicy>
+class PolicyCache {
+private:
+    Policy<K, V> policy;
+
+    // Validate before the policy sizes its segments from `cap`.
+    static size_t checkedCapacity(size_t cap) {
+        if (cap == 0) {
+            throw std::invalid_argument("PolicyCache capacity must be at least 1");
+        }
+        return cap;
+    }
+
+public:
+    PolicyCache(size_t cap) : policy(checkedCapacity(cap)) {}
+
+    // Pointer to the cached value, or nullptr on a miss. Records the access with the policy.
+    V* try_get(const K& key) {
+        return policy.find(key);
+    }
+
+    // Get value by key. Throws std::runtime_error on a miss (same contract as LRUCache).
+    V get(const K& key) {
+        V* value = policy.find(key);
+        if (!value) {
+            throw std::runtime_error("Key not found");
+        }
+        return *value;
+    }
+
+    // Insert or Update value.
+    // Note: with an admission policy (TinyLFUPolicy) a new key may be rejected immediately
+    // if it is colder than the entry it would replace.
+    void put(const K& key, const V& value) {
+        if (V* existing = policy.find(key)) {
+            *existing = value;
+            return;
+        }
+        policy.insert(key, value);
+    }
+
+    size_t size() const {
+        return policy.size();
+    }
+};
+
+#endif // POLICY_CACHE_HPP
@@ -0,0 +1,138 @@
+#ifndef POOL_TRACE_HPP
+#define POOL_TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Pool Tracing (per-worker counters + task timeline)
+// Goal: See what a thread pool does (who ran what, how long tasks queued, where workers sat idle)
+//       without slowing it down.
+// Mechanics:
+// 1. Counters: one cache line per worker, written only by that worker (relaxed atomics: no lock,
+//    no false sharing). Readers sum them whenever they like.
+// 2. TraceRing: a fixed-size ring of TaskTraceEvent per worker. One writer (the owning worker),
+//    any number of readers. When full, the oldest events are overwritten (a trace never blocks the pool).
+//    - Each slot is a tiny seqlock: the writer makes `seq` odd, writes the fields, makes it even again.
+//      A reader copies the fields and keeps them only if `seq` was the same even value before and after.
+// 3. writeChromeTrace(): JSON in the Chrome trace-event format. Open it in chrome://tracing or
+//    https://ui.perfetto.dev: one row per worker, a bar per task, gaps between bars = idle time.
+
+// One task: when it was queued, started and finished (ns since the pool started) and where it ran.
+struct TaskTraceEvent {
+    uint64_t enqueueNs = 0;
+    uint64_t startNs = 0;
+    uint64_t finishNs = 0;
+    uint32_t worker = 0;
+};
+
+// Counters of one worker. Times are only measured with Options::instrument (else 0).
+struct WorkerStats {
+    uint64_t tasksExecuted = 0;
+    uint64_t tasksStolen = 0; // Taken from another worker's deque (work-stealing mode)
+    uint64_t busyNs = 0;      // Running tasks
+    uint64_t idleNs = 0;      // Alive but not running a task (looking for work, spinning, parked)
+    uint64_t waitNs = 0;      // Total time the tasks it ran spent queued
+
+    double utilization() const {
+        uint64_t alive = busyNs + idleNs;
+        return alive == 0 ? 0.0 : static_cast<double>(busyNs) / alive;
+    }
+};
+
+// Single-writer, overwrite-oldest ring of trace events (capacity rounded up to a power of two).
+class TraceRing {
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0}; // 2i+1 while event i is being written, 2i+2 once it is complete
+        std::atomic<uint64_t> enqueueNs{0}, startNs{0}, finishNs{0};
+        std::atomic<uint32_t> worker{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    std::atomic<uint64_t> head{0}; // Events ever pushed
+
+public:
+    explicit TraceRing(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        slots = std::make_unique<Slot[]>(cap);
+        mask = cap - 1;
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    // Events lost to overwriting.
+    uint64_t dropped() const {
+        uint64_t h = head.load(std::memory_order_acquire);
+        return h > capacity() ? h - capacity() : 0;
+    }
+
+    // Writer thread only.
+    void push(const TaskTraceEvent& e) {
+        uint64_t i = head.load(std::memory_order_relaxed);
+        Slot& s = slots[i & mask];
+        s.seq.store(2 * i + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release); // Odd seq is visible before any field changes
+        s.enqueueNs.store(e.enqueueNs, std::memory_order_relaxed);
+        s.startNs.store(e.startNs, std::memory_order_relaxed);
+        s.finishNs.store(e.finishNs, std::memory_order_relaxed);
+        s.worker.store(e.worker, std::memory_order_relaxed);
+        s.seq.store(2 * i + 2, std::memory_order_release);
+        head.store(i + 1, std::memory_order_release);
+    }
+
+    // Any thread: append the events still in the ring, oldest first. Slots being overwritten are skipped.
+    void collect(std::vector<TaskTraceEvent>& out) const {
+        uint64_t h = head.load(std::memory_order_acquire);
+        for (uint64_t i = h > capacity() ? h - capacity() : 0; i < h; ++i) {
+            const Slot& s = slots[i & mask];
+            uint64_t before = s.seq.load(std::memory_order_acquire);
+            if (before != 2 * i + 2) continue;
+            TaskTraceEvent e;
+            e.enqueueNs = s.enqueueNs.load(std::memory_order_relaxed);
+            e.startNs = s.startNs.load(std::memory_order_relaxed);
+            e.finishNs = s.finishNs.load(std::memory_order_relaxed);
+            e.worker = s.worker.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire); // Fields are read before seq is re-checked
+            if (s.seq.load(std::memory_order_relaxed) == before) {
+                out.push_back(e);
+            }
+        }
+    }
+};
+
+// Chrome trace-event JSON. Workers 0..workers-1 get one row each; worker == workers is "helpers"
+// (threads that ran tasks inside wait_idle() / TaskGroup::join(), or inline on a full queue).
+// Each task is a complete ("X") event; its queue wait is an async span on a "queued" row.
+inline void writeChromeTrace(std::ostream& os, const std::vector<TaskTraceEvent>& events, size_t workers) {
+    auto us = [](uint64_t ns) { return std::to_string(ns / 1000) + "." + std::to_string(ns % 1000 + 1000).substr(1); };
+    const char* sep = "\n";
+    os << "{\"traceEvents\":[";
+    for (size_t w = 0; w <= workers; ++w) {
+        std::string name = w < workers ? "worker " + std::to_string(w) : "helpers";
+        os << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << w
+           << ",\"args\":{\"name\":\"" << name << "\"}}";
+        sep = ",\n";
+    }
+    uint64_t id = 0;
+    for (const TaskTraceEvent& e : events) {
+        os << sep << "{\"name\":\"task\",\"cat\":\"run\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.worker
+           << ",\"ts\":" << us(e.startNs) << ",\"dur\":" << us(e.finishNs - e.startNs)
+           << ",\"args\":{\"wait_us\":" << us(e.startNs - e.enqueueNs) << "}}";
+        os << sep << "{\"name\":\"queued\",\"cat\":\"wait\",\"ph\":\"b\",\"id\":" << id
+           << ",\"pid\":0,\"tid\":" << e.worker << ",\"ts\":" << us(e.enqueueNs) << "}";
+        os << sep << "{\"name\":\"queued\",\"cat\":\"wait\",\"ph\":\"e\",\"id\":" << id
+           << ",\"pid\":0,\"tid\":" << e.worker << ",\"ts\":" << us(e.startNs) << "}";
+        ++id;
+    }
+    os << "\n]}\n";
+}
+
+#endif // POOL_TRACE_HPP
@@ -0,0 +1,198 @@
+#ifndef POOLED_LRU_CACHE_HPP
+#define POOLED_LRU_CACHE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Pooled LRU Cache (Allocation-free at steady state)
+// Goal: Same behavior as LRUCache, but without a heap allocation per insert.
+// Mechanics:
+// 1. Problem: LRUCache allocates a std::list node AND an unordered_map node on every miss,
+//    and frees both on every eviction. A full cache churns the allocator on every put().
+// 2. Slot Pool (std::vector<Slot>): All `capacity` entries are allocated once, up front.
+//    - The linked list is intrusive: each slot stores prev/next as array indices, not pointers.
+//    - Eviction does not free anything. The victim's slot is overwritten in place with the new entry.
+// 3. Open-Addressing Index (std::vector<Bucket>): Maps Key -> Slot index.
+//    - Flat array with linear probing, sized to a power of two >= 2 * capacity (load factor <= 0.5).
+//    - Erase uses "backward shift" instead of tombstones, so probe chains never degrade.
+// Note: K and V must be default-constructible. Puts do no allocation of their own; a V that owns
+//       heap memory (e.g. std::string) may still allocate inside its own assignment operator.
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class PooledLRUCache {
+private:
+    static constexpr uint32_t kNil = std::numeric_limits<uint32_t>::max();
+
+    struct Slot {
+        K key{};
+        V value{};
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t hash = 0; // Cached so eviction never re-hashes the victim's key
+    };
+
+    // The bucket keeps a copy of the hash, so probing and backward shifts
+    // compare integers in the table and only touch a Slot on a real candidate.
+    struct Bucket {
+        uint32_t slot = kNil;
+        uint32_t hash = 0;
+    };
+
+    size_t capacity;
+    size_t count = 0;
+    uint32_t head = kNil; // Most Recently Used
+    uint32_t tail = kNil; // Least Recently Used
+    std::vector<Slot> slots;
+    std::vector<Bucket> table; // slot == kNil means empty
+    size_t mask;
+    Hash hasher;
+
+    uint32_t hashOf(const K& key) const {
+        uint64_t h = hasher(key);
+        // Full MurmurHash3 finalizer: std::hash<int> is the identity, and linear probing
+        // clusters badly unless every input bit affects the low (bucket) bits.
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<uint32_t>(h);
+    }
+
+    // Returns the bucket holding `key`, or the empty bucket where it would be inserted.
+    size_t findBucket(const K& key, uint32_t h) const {
+        size_t b = h & mask;
+        while (table[b].slot != kNil &&
+               !(table[b].hash == h && slots[table[b].slot].key == key)) {
+            b = (b + 1) & mask;
+        }
+        return b;
+    }
+
+    // Returns the bucket pointing at slot `s` (which must be present).
+    size_t bucketOfSlot(uint32_t s) const {
+        size_t b = slots[s].hash & mask;
+        while (table[b].slot != s) {
+            b = (b + 1) & mask;
+        }
+        return b;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe chain into the hole,
+    // so lookups never need tombstones. Returns the bucket that ends up empty.
+    size_t eraseBucket(size_t hole) {
+        size_t j = hole;
+        while (true) {
+            j = (j + 1) & mask;
+            if (table[j].slot == kNil) {
+                break;
+            }
+            size_t k = table[j].hash & mask;
+            // The entry at j may move to `hole` only if its home is NOT cyclically in (hole, j].
+            bool homeBetween = (hole <= j) ? (hole < k && k <= j) : (hole < k || k <= j);
+            if (!homeBetween) {
+                table[hole] = table[j];
+                hole = j;
+            }
+        }
+        table[hole] = Bucket{};
+        return hole;
+    }
+
+    void unlink(uint32_t s) {
+        Slot& slot = slots[s];
+        if (slot.prev != kNil) slots[slot.prev].next = slot.next; else head = slot.next;
+        if (slot.next != kNil) slots[slot.next].prev = slot.prev; else tail = slot.prev;
+        slot.prev = slot.next = kNil;
+    }
+
+    void pushFront(uint32_t s) {
+        slots[s].prev = kNil;
+        slots[s].next = head;
+        if (head != kNil) slots[head].prev = s;
+        head = s;
+        if (tail == kNil) tail = s;
+    }
+
+    void moveToFront(uint32_t s) {
+        if (s == head) return;
+        unlink(s);
+        pushFront(s);
+    }
+
+    // Runs in the member initializer list, before `slots` allocates `cap` entries.
+    static size_t checkedCapacity(size_t cap) {
+        if (cap == 0 || cap >= kNil) {
+            throw std::invalid_argument("PooledLRUCache capacity must be in [1, 2^32 - 1)");
+        }
+        return cap;
+    }
+
+public:
+    PooledLRUCache(size_t cap) : capacity(checkedCapacity(cap)), slots(capacity) {
+        size_t buckets = 1;
+        while (buckets < 2 * cap) {
+            buckets <<= 1;
+        }
+        table.assign(buckets, Bucket{});
+        mask = buckets - 1;
+    }
+
+    // Get value by key
+    // Complexity: O(1) expected. Throws std::runtime_error on a miss (same contract as LRUCache).
+    V get(const K& key) {
+        uint32_t s = table[findBucket(key, hashOf(key))].slot;
+        if (s == kNil) {
+            throw std::runtime_error("Key not found");
+        }
+        moveToFront(s);
+        return slots[s].value;
+    }
+
+    // Insert or Update value
+    // Complexity: O(1) expected, zero allocations.
+    void put(const K& key, const V& value) {
+        uint32_t h = hashOf(key);
+        size_t b = findBucket(key, h);
+
+        // Case 1: Update existing key
+        if (table[b].slot != kNil) {
+            uint32_t s = table[b].slot;
+            moveToFront(s);
+            slots[s].value = value;
+            return;
+        }
+
+        // Case 2: Insert new key
+        uint32_t s;
+        if (count == capacity) {
+            // Recycle the LRU slot in place instead of freeing it.
+            s = tail;
+            size_t hole = eraseBucket(bucketOfSlot(s));
+            unlink(s);
+            // Every bucket from our home up to b was occupied. If the shift emptied one of
+            // them, that is now the first free bucket on our probe path.
+            if (((hole - (h & mask)) & mask) < ((b - (h & mask)) & mask)) {
+                b = hole;
+            }
+        } else {
+            s = static_cast<uint32_t>(count++);
+        }
+
+        slots[s].key = key;
+        slots[s].value = value;
+        slots[s].hash = h;
+        pushFront(s);
+        table[b] = Bucket{s, h};
+    }
+
+    // Helper for debugging/testing
+    size_t size() const {
+        return count;
+    }
+};
+
+#endif // POOLED_LRU_CACHE_HPP
@@ -0,0 +1,108 @@
+#ifndef PRIORITY_LANES_HPP
+#define PRIORITY_LANES_HPP
+
+#include <cstdint>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "systemDesign/ringDeque.hpp"
+
+// Priority Lanes (multi-level FIFO with starvation protection)
+// Goal: Latency-sensitive work must not wait behind a batch of background jobs.
+// Mechanics:
+// 1. One FIFO per lane. Lane 0 is the most urgent, lane N-1 the least.
+//    pop() serves the most urgent non-empty lane. Inside a lane, order stays FIFO.
+// 2. Starvation protection: strict priority alone would never run lane N-1 while lane 0 is busy.
+//    Every time a non-empty lane is passed over, its `skipped` counter goes up. Once it reaches
+//    starvationLimit, that lane is served next (a "rescue") and its counter resets.
+//    -> a waiting lane gets at least 1 of every (starvationLimit + 1) pops, however busy the others are.
+// 3. Per-lane metrics: current depth, high-water mark, pushed / popped / rescued counts.
+// Not thread-safe: ThreadPool uses it under queueMutex.
+
+struct LaneStats {
+    size_t depth = 0;    // Tasks waiting right now
+    size_t maxDepth = 0; // High-water mark
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t rescued = 0; // Pops granted by starvation protection
+};
+
+template <typename T>
+class PriorityLanes {
+private:
+    struct Lane {
+        std::queue<T, RingDeque<T>> items;
+        size_t skipped = 0;
+        LaneStats stats;
+    };
+
+    std::vector<Lane> lanes;
+    size_t starvationLimit;
+    size_t total = 0;
+
+public:
+    explicit PriorityLanes(size_t laneCount = 1, size_t starvationLimit_ = 16)
+        : lanes(laneCount), starvationLimit(starvationLimit_) {
+        if (laneCount == 0) {
+            throw std::invalid_argument("PriorityLanes needs at least one lane");
+        }
+        if (starvationLimit == 0) {
+            throw std::invalid_argument("PriorityLanes starvationLimit must be at least 1");
+        }
+    }
+
+    bool empty() const { return total == 0; }
+    size_t size() const { return total; }
+    size_t laneCount() const { return lanes.size(); }
+    size_t depth(size_t lane) const { return lanes.at(lane).items.size(); }
+
+    void push(size_t lane, T&& item) {
+        if (lane >= lanes.size()) {
+            throw std::out_of_range("priority lane out of range");
+        }
+        Lane& l = lanes[lane];
+        l.items.push(std::move(item));
+        ++total;
+        ++l.stats.pushed;
+        if (l.items.size() > l.stats.maxDepth) {
+            l.stats.maxDepth = l.items.size();
+        }
+    }
+
+    // Precondition: !empty().
+    T pop() {
+        size_t pick = lanes.size();
+        bool rescue = false;
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            if (lanes[i].items.empty()) continue;
+            if (pick == lanes.size()) {
+                pick = i; // Most urgent non-empty lane
+            } else if (lanes[i].skipped >= starvationLimit) {
+                pick = i; // A less urgent lane waited long enough
+                rescue = true;
+                break;
+            }
+        }
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            if (i != pick && !lanes[i].items.empty()) ++lanes[i].skipped;
+        }
+
+        Lane& l = lanes[pick];
+        l.skipped = 0;
+        ++l.stats.popped;
+        if (rescue) ++l.stats.rescued;
+        T item = std::move(l.items.front());
+        l.items.pop();
+        --total;
+        return item;
+    }
+
+    LaneStats stats(size_t lane) const {
+        LaneStats s = lanes.at(lane).stats;
+        s.depth = lanes[lane].items.size();
+        return s;
+    }
+};
+
+#endif // PRIORITY_LANES_HPP
@@ -0,0 +1,98 @@
+#ifndef RING_DEQUE_HPP
+#define RING_DEQUE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Ring Deque (growable circular buffer, the container behind a std::queue)
+// Goal: A FIFO that stops allocating once it has grown to its working size.
+// Mechanics:
+// 1. Problem: std::deque (std::queue's default container) allocates a ~512-byte block every few
+//    pushes and frees it again once popped past. A queue that keeps cycling keeps allocating.
+// 2. RingDeque keeps one power-of-two array with head/size indices. push_back writes at
+//    (head + size) & mask, pop_front advances head. Capacity doubles when full and never shrinks.
+// 3. Provides exactly what std::queue needs: std::queue<T, RingDeque<T>>.
+
+template <typename T>
+class RingDeque {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    T* slots = nullptr; // Raw storage: only [head, head + count) holds live objects
+    size_t capacity = 0;
+    size_t head = 0;
+    size_t count = 0;
+
+    T* at(size_t i) const { return slots + ((head + i) & (capacity - 1)); }
+
+    void grow() {
+        size_t bigger = capacity ? capacity * 2 : 16;
+        T* fresh = static_cast<T*>(::operator new(bigger * sizeof(T), std::align_val_t(alignof(T))));
+        for (size_t i = 0; i < count; ++i) {
+            T* old = at(i);
+            ::new (static_cast<void*>(fresh + i)) T(std::move(*old));
+            old->~T();
+        }
+        release();
+        slots = fresh;
+        capacity = bigger;
+        head = 0;
+    }
+
+    void release() {
+        if (slots) {
+            ::operator delete(slots, std::align_val_t(alignof(T)));
+        }
+    }
+
+public:
+    RingDeque() = default;
+    RingDeque(const RingDeque&) = delete;
+    RingDeque& operator=(const RingDeque&) = delete;
+
+    RingDeque(RingDeque&& other) noexcept
+        : slots(std::exchange(other.slots, nullptr)), capacity(std::exchange(other.capacity, 0)),
+          head(std::exchange(other.head, 0)), count(std::exchange(other.count, 0)) {}
+
+    ~RingDeque() {
+        while (count > 0) {
+            pop_front();
+        }
+        release();
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    T& front() { return *at(0); }
+    const T& front() const { return *at(0); }
+    T& back() { return *at(count - 1); }
+    const T& back() const { return *at(count - 1); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == capacity) {
+            grow();
+        }
+        T* slot = ::new (static_cast<void*>(at(count))) T(std::forward<Args>(args)...);
+        ++count;
+        return *slot;
+    }
+
+    void push_back(const T& v) { emplace_back(v); }
+    void push_back(T&& v) { emplace_back(std::move(v)); }
+
+    void pop_front() {
+        at(0)->~T();
+        head = (head + 1) & (capacity - 1);
+        --count;
+    }
+};
+
+#endif // RING_DEQUE_HPP
@@ -0,0 +1,87 @@
+#ifndef SHARDED_LRU_CACHE_HPP
+#define SHARDED_LRU_CACHE_HPP
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "systemDesign/lruCache.hpp"
+
+// Sharded LRU Cache
+// Goal: A thread-safe LRU cache whose throughput scales with the number of cores.
+// Mechanics:
+// 1. Problem: LRUCache::get() splices the list, so even a read is a write.
+//    Wrapping the whole cache in one mutex serializes every thread behind that lock.
+// 2. Sharding: Split the key space into N independent LRUCaches ("shards"), each with its own mutex.
+//    - hash(key) % N picks the shard. Two threads only contend if their keys land on the same shard.
+//    - Each shard evicts on its own, so recency is exact per shard but approximate globally.
+// 3. Capacity is per shard: total capacity = numShards * capacityPerShard.
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class ShardedLRUCache {
+private:
+    // alignas(64): Keep each shard's mutex on its own cache line to avoid false sharing.
+    struct alignas(64) Shard {
+        std::mutex mtx;
+        LRUCache<K, V> cache;
+
+        explicit Shard(size_t cap) : cache(cap) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards; // Shard holds a mutex, so it is not movable
+    Hash hasher;
+
+    Shard& shardFor(const K& key) {
+        size_t h = hasher(key);
+        // std::hash<int> is the identity on most standard libraries, so mix the bits
+        // before taking the modulo to stop sequential keys from clustering.
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return *shards[h % shards.size()];
+    }
+
+public:
+    ShardedLRUCache(size_t numShards, size_t capacityPerShard) {
+        if (numShards == 0) {
+            throw std::invalid_argument("ShardedLRUCache needs at least one shard");
+        }
+        shards.reserve(numShards);
+        for (size_t i = 0; i < numShards; ++i) {
+            shards.push_back(std::make_unique<Shard>(capacityPerShard));
+        }
+    }
+
+    // Get value by key. Throws std::runtime_error on a miss (same contract as LRUCache).
+    // Only the owning shard is locked.
+    V get(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        return shard.cache.get(key);
+    }
+
+    // Insert or Update value. Eviction happens inside the owning shard only.
+    void put(const K& key, const V& value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.cache.put(key, value);
+    }
+
+    // Total number of entries across all shards.
+    // Locks shards one at a time, so the result is a snapshot, not an atomic total.
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mtx);
+            total += shard->cache.size();
+        }
+        return total;
+    }
+
+    size_t shardCount() const {
+        return shards.size();
+    }
+};
+
+#endif // SHARDED_LRU_CACHE_HPP
@@ -0,0 +1,230 @@
+#ifndef TASK_FUTURE_HPP
+#define TASK_FUTURE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Task Future (lightweight promise/future for ThreadPool::submit)
+// Goal: Get a task's result (or its exception) back, without the cost of std::packaged_task.
+// Mechanics:
+// 1. Problem: std::packaged_task + std::future allocate several times per task
+//    (shared state, the packaged_task itself because std::function needs it copyable, the std::function box).
+// 2. One heap block per task holds BOTH the callable and the result slot (TaskJob = TaskState + callable).
+//    The queued job is just a pointer to that block: always fits the task queue's inline buffer.
+// 3. Shared ownership by an intrusive reference count (2 = the job + the future). Whoever lets go
+//    last deletes the block. No std::shared_ptr control block.
+// 4. Waiting uses C++20 std::atomic::wait on the `ready` flag (a futex on Linux): no mutex, no
+//    condition variable, and set() only makes a syscall when someone is actually waiting.
+// 5. Exceptions thrown by the task are caught and stored as std::exception_ptr; get() rethrows them.
+
+// Result slot shared by the producer (job or TaskPromise) and the TaskFuture.
+template <typename T>
+class TaskState {
+private:
+    struct Unit {};
+    using Stored = std::conditional_t<std::is_void_v<T>, Unit, T>;
+
+    std::atomic<uint32_t> refs{2}; // Producer + future
+    std::atomic<bool> ready{false};
+    std::optional<Stored> value;
+    std::exception_ptr error;
+
+public:
+    virtual ~TaskState() = default;
+
+    void release() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    template <typename... A>
+    void setValue(A&&... a) {
+        value.emplace(std::forward<A>(a)...);
+        publish();
+    }
+
+    void setException(std::exception_ptr e) {
+        error = std::move(e);
+        publish();
+    }
+
+    // Run `fn` and store whatever it returns or throws.
+    template <typename Fn>
+    void fulfill(Fn& fn) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                std::invoke(fn);
+                setValue();
+            } else {
+                setValue(std::invoke(fn));
+            }
+        } catch (...) {
+            setException(std::current_exception());
+        }
+    }
+
+    bool isReady() const {
+        return ready.load(std::memory_order_acquire);
+    }
+
+    void wait() const {
+        while (!ready.load(std::memory_order_acquire)) {
+            ready.wait(false, std::memory_order_acquire);
+        }
+    }
+
+    // Call once, after wait().
+    T take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*value);
+        }
+    }
+
+private:
+    void publish() {
+        ready.store(true, std::memory_order_release);
+        ready.notify_all();
+    }
+};
+
+// Consumer side. Move-only, one-shot get() (like std::future).
+// Unlike the future from std::async, the destructor never blocks.
+template <typename T>
+class TaskFuture {
+private:
+    TaskState<T>* state = nullptr;
+
+public:
+    TaskFuture() = default;
+    explicit TaskFuture(TaskState<T>* s) : state(s) {}
+
+    TaskFuture(TaskFuture&& other) noexcept : state(std::exchange(other.state, nullptr)) {}
+    TaskFuture& operator=(TaskFuture&& other) noexcept {
+        if (this != &other) {
+            reset();
+            state = std::exchange(other.state, nullptr);
+        }
+        return *this;
+    }
+    TaskFuture(const TaskFuture&) = delete;
+    TaskFuture& operator=(const TaskFuture&) = delete;
+
+    ~TaskFuture() {
+        reset();
+    }
+
+    bool valid() const { return state != nullptr; }
+    bool ready() const { return state && state->isReady(); }
+
+    void wait() const {
+        if (!state) throw std::logic_error("TaskFuture has no state");
+        state->wait();
+    }
+
+    // Block until the task finished, then return its result or rethrow its exception.
+    // Afterwards the future is empty (valid() == false).
+    T get() {
+        wait();
+        TaskState<T>* s = std::exchange(state, nullptr);
+        struct Release {
+            TaskState<T>* s;
+            ~Release() { s->release(); }
+        } guard{s};
+        return s->take();
+    }
+
+private:
+    void reset() {
+        if (state) {
+            std::exchange(state, nullptr)->release();
+        }
+    }
+};
+
+// Producer side for results computed outside ThreadPool::submit (callbacks, I/O completions).
+// Destroying an unfulfilled promise stores a "broken promise" error so the future never hangs.
+template <typename T>
+class TaskPromise {
+private:
+    TaskState<T>* state;
+    bool futureTaken = false;
+    bool fulfilled = false;
+
+    TaskState<T>& checkedState() {
+        if (fulfilled) throw std::logic_error("TaskPromise already satisfied");
+        return *state;
+    }
+
+public:
+    TaskPromise() : state(new TaskState<T>()) {}
+
+    TaskPromise(TaskPromise&& other) noexcept
+        : state(std::exchange(other.state, nullptr)), futureTaken(other.futureTaken), fulfilled(other.fulfilled) {}
+    TaskPromise& operator=(TaskPromise&&) = delete;
+    TaskPromise(const TaskPromise&) = delete;
+    TaskPromise& operator=(const TaskPromise&) = delete;
+
+    ~TaskPromise() {
+        if (!state) return;
+        if (!fulfilled) {
+            state->setException(std::make_exception_ptr(std::runtime_error("broken promise")));
+        }
+        if (!futureTaken) {
+            state->release(); // Nobody will ever hold the future's reference
+        }
+        state->release();
+    }
+
+    TaskFuture<T> get_future() {
+        if (futureTaken) throw std::logic_error("TaskPromise future already retrieved");
+        futureTaken = true;
+        return TaskFuture<T>(state);
+    }
+
+    template <typename... A>
+    void set_value(A&&... a) {
+        checkedState().setValue(std::forward<A>(a)...);
+        fulfilled = true;
+    }
+
+    void set_exception(std::exception_ptr e) {
+        checkedState().setException(std::move(e));
+        fulfilled = true;
+    }
+};
+
+// TaskState + the callable in the same allocation. Used by ThreadPool::submit.
+template <typename T, typename Fn>
+class TaskJob final : public TaskState<T> {
+private:
+    std::optional<Fn> fn;
+
+public:
+    explicit TaskJob(Fn f) : fn(std::move(f)) {}
+
+    // Runs the task, frees its captures right away, then drops the job's reference.
+    void run() {
+        this->fulfill(*fn);
+        fn.reset();
+        this->release();
+    }
+
+    // The job will never run (e.g. the queue rejected it): fail the future instead.
+    void cancel(std::exception_ptr reason) {
+        this->setException(std::move(reason));
+        fn.reset();
+        this->release();
+    }
+};
+
+#endif // TASK_FUTURE_HPP
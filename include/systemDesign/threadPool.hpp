@@ -1,85 +1,1193 @@
 #ifndef THREAD_POOL_HPP
 #define THREAD_POOL_HPP
 
+#include <algorithm>
 #include <vector>
 #include <thread>
 #include <queue>
 #include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
 #include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include "systemDesign/chaseLevDeque.hpp"
+#include "systemDesign/cpuTopology.hpp"
+#include "systemDesign/inlineTask.hpp"
+#include "systemDesign/mpmcQueue.hpp"
+#include "systemDesign/poolTrace.hpp"
+#include "systemDesign/priorityLanes.hpp"
+#include "systemDesign/ringDeque.hpp"
+#include "systemDesign/spinWait.hpp"
+#include "systemDesign/taskFuture.hpp"
+#include "systemDesign/timerQueue.hpp"
 
 // Thread Pool
 // Goal: Re-use a fixed number of threads to execute many tasks, avoiding the overhead of creating/destroying threads.
 // Mechanics:
-// 1. Task Queue: A queue of std::function objects (jobs to do).
+// 1. Task Queue: A queue of InlineTask objects (jobs to do).
+//    - InlineTask keeps captures up to 64 bytes inside the queue slot (std::function: ~16 bytes),
+//      and the queue is a RingDeque that stops allocating once grown. Enqueue -> run -> done
+//      normally costs zero heap allocations.
 // 2. Worker Threads: A vector of threads that infinite-loop, waiting for tasks.
 // 3. Synchronization:
 //    - Mutex: Protects the queue from race conditions.
 //    - Condition Variable: Allows threads to sleep when queue is empty and wake up when a task is added.
+// 4. Work-Stealing mode (Options::workStealing):
+//    - Problem: with one shared queue, every enqueue and every dequeue fights over queueMutex.
+//      With tiny tasks on many cores, threads spend more time waiting for the lock than working.
+//    - Each worker owns a lock-free ChaseLevDeque. A task enqueued FROM a worker goes to that worker's
+//      own deque (no lock, LIFO = cache-hot). Tasks from outside threads go to the shared queue.
+//    - A worker with nothing to do steals the oldest task from another worker's deque.
+//    - The mutex/condition variable are only used to sleep when there is no work anywhere.
+// 5. submit(): like enqueue, but returns a TaskFuture with the result (or the exception) of the task.
+//    One allocation per task: the callable and its result slot share a TaskJob block.
+// 6. Waiting without sleeping blindly:
+//    - `outstanding` counts tasks queued or running. wait_idle() returns once it drops to 0.
+//    - TaskGroup counts only its own tasks, so a caller can fork N tasks and join() just those.
+//    - Helping: while it waits, the waiting thread pops queued tasks and runs them itself.
+//      A core is never parked while there is work, and a task can join() its own children
+//      even on a 1-thread pool without deadlocking.
+// 7. Bounded lock-free queue (Options::queue = Queue::BoundedLockFree):
+//    - Problem: the std::queue is unbounded. Under overload it grows until the process runs out of
+//      memory, and every push/pop takes queueMutex.
+//    - The shared queue becomes a fixed-size MPMCQueue (Vyukov ring). No lock on push or pop.
+//    - When it is full, Options::whenFull decides: Block (wait for room), Spin (retry),
+//      Reject (enqueue returns false, submit's future throws TaskRejected), or RunInline
+//      (the caller runs the task itself: natural backpressure).
+//    - A worker never waits for room (it could be waiting for itself): Block/Spin run inline there.
+// 8. Priority lanes (Options::priorityLanes, mutex queue only):
+//    - Problem: one FIFO means a latency-sensitive request waits behind every background job queued before it.
+//    - The shared queue becomes PriorityLanes: lane 0 is the most urgent. Workers always take the most
+//      urgent queued task, but a lane that keeps being passed over is served after starvationLimit skips.
+//    - enqueue(f) / submit(f) use the least urgent lane; enqueue(lane, f) / submit_priority(lane, f) pick one.
+//    - laneStats(lane): queue depth, high-water mark and counters per lane.
+//    - Work-stealing mode: only least-urgent tasks spawned by a worker go to its local deque.
+//      Urgent ones always go through the lanes, and while any is queued (`urgentPending`) a worker looks at
+//      the lanes before its own deque, so they cannot get stuck behind local work.
+// 9. Placement (Options::pinWorkers, Options::numaAware):
+//    - pinWorkers: worker i is pinned to one allowed CPU (node by node), so the scheduler stops
+//      migrating it and its caches stay warm.
+//    - numaAware: workers are grouped per NUMA node (and restricted to that node's CPUs).
+//      Each node gets its own queue. enqueue_on_node(node, f) / submit_on_node(node, f) put work
+//      next to the memory it uses, and a task spawned by a worker stays on its node.
+//      A worker looks at its own node's queue first, and steals from its own node before
+//      crossing to another one. Another node's queue is only raided when it has a backlog
+//      (2+ tasks) or no workers of its own: a lone task waits for its own node instead of
+//      running far from its memory.
+//    - The constructor, resize() and the elastic controller wait for each new worker's pinning attempt
+//      before they return, so pinnedWorkers() is exact as soon as they do.
+// 10. Idling (Options::idleSpin, Options::idleYields):
+//    - Problem: a worker that runs out of work parks on the condition variable at once. The next task
+//      then pays for a futex wake + context switch before it starts: microseconds, for bursty load
+//      that is most of its latency.
+//    - With idleSpin > 0 a worker first spins (cpuRelax) for up to that long, then yields idleYields
+//      times, and only then parks (IdleBackoff). The spin budget adapts: it grows while spinning
+//      catches work and shrinks while it does not, so a pool that stays idle soon parks at once.
+//    - Every mode counts parked workers (`sleepers`). enqueue() only calls notify_one() when one is
+//      parked: while workers are busy or spinning, a push costs no syscall.
+// 11. Elastic size (Options::minThreads / maxThreads, resize()):
+//    - Problem: a fixed worker count is either too many threads off-peak or too few at peak.
+//    - Per-worker state (deques, placement) is allocated once for maxThreads "slots";
+//      only the threads come and go, so workers never see those vectors change.
+//    - Grow: a controller thread ticks every growAfter. If a task started during the tick after waiting
+//      longer than growAfter, or work stayed queued for the whole tick while nothing started,
+//      one worker is added (up to maxThreads). Elastic pools stamp every task with its enqueue time for this.
+//    - Shrink: a worker that found no work for idleTimeout retires itself (down to minThreads).
+//    - resize(n) sets the count directly. Nothing queued is dropped: a retiring worker first empties
+//      its own deque, and the shared/node queues are served by the others.
+// 12. Instrumentation (Options::instrument, Options::traceEvents; see poolTrace.hpp):
+//    - Always on: per-worker tasksExecuted / tasksStolen, relaxed atomics on the worker's own cache line.
+//      queuedTasks() sums the queue depths.
+//    - instrument: tasks are stamped at enqueue (like elastic pools). Each worker also adds up queue wait
+//      and busy time; idle = lifetime - busy. Costs three clock reads per task (enqueue, start, finish):
+//      on sub-microsecond tasks that is a visible slowdown (thread_pool_bench), on real work it is noise.
+//    - traceEvents > 0: each worker also records enqueue/start/finish of its last N tasks in its own
+//      lock-free TraceRing. writeChromeTrace() dumps them for chrome://tracing or Perfetto.
+// 13. Timers (schedule_after / schedule_every, see timerQueue.hpp):
+//    - Problem: heartbeats, cache sweeps and retries each got their own std::thread + sleep_for loop.
+//    - One timer thread per pool (started on first use) keeps a min-heap of deadlines and enqueues each
+//      due timer as an ordinary task, so timed work shares the workers (and their queue) with the rest.
+//    - Returns a CancelToken; pass one in to cancel a whole group of timers with one cancel().
+//    - The timer thread never waits for queue room and never runs a callback itself: when a bounded queue
+//      is full (whatever whenFull says) the run is dropped and counted in droppedTimerRuns().
+//    - Teardown: the destructor closes the timers before stopping the timer thread. A task that re-arms
+//      itself meanwhile (retry, heartbeat) gets back an already-cancelled token instead of a timer.
+//    - Jitter = timer lateness (the thread wakes timerSpin early and spins to the deadline) + the usual
+//      enqueue-to-start latency. Idle workers that park add a futex wake to the second part (idleSpin helps).
+
+// Thrown through TaskFuture::get() / TaskGroup::join() when a full queue rejected the task.
+class TaskRejected : public std::runtime_error {
+public:
+    TaskRejected() : std::runtime_error("ThreadPool queue is full: task rejected") {}
+};
 
 class ThreadPool {
+public:
+    enum class Queue { Mutex, BoundedLockFree };
+    enum class FullPolicy { Block, Spin, Reject, RunInline };
+
+    struct Options {
+        size_t threads = std::thread::hardware_concurrency();
+        bool workStealing = false;
+        Queue queue = Queue::Mutex;
+        size_t queueCapacity = 1024;            // BoundedLockFree only (rounded up to a power of two)
+        FullPolicy whenFull = FullPolicy::Block; // BoundedLockFree only
+        size_t priorityLanes = 1;                // Mutex queue only. Lane 0 = most urgent
+        size_t starvationLimit = 16;             // A waiting lane is served at least every N+1 pops
+        bool pinWorkers = false;                 // One CPU per worker
+        bool numaAware = false;                  // Per-node worker groups and queues
+        std::chrono::microseconds idleSpin{0};   // Spin this long before parking (0 = park at once)
+        uint32_t idleYields = 0;                 // Then yield this many times before parking
+        size_t minThreads = 0;                   // Elastic: shrink down to this (0 = threads: no shrinking)
+        size_t maxThreads = 0;                   // Elastic: grow up to this (0 = threads: no growing)
+        std::chrono::microseconds growAfter{1000};  // Elastic: grow when tasks wait longer than this
+        std::chrono::milliseconds idleTimeout{5000}; // Elastic: a worker idle this long retires
+        bool instrument = false;                 // Time tasks: wait / busy / idle per worker
+        size_t traceEvents = 0;                  // Keep the last N task events per worker (implies instrument)
+        std::chrono::microseconds timerSpin{50}; // Timers: spin this long before a deadline instead of sleeping
+    };
+
 private:
-    std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    using Task = InlineTask<64>;
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::thread> workers; // One slot per possible worker; a slot without a thread is not joinable
+    PriorityLanes<Task> tasks; // Shared queue (work-stealing mode: only tasks from non-worker threads)
     
     std::mutex queueMutex;
     std::condition_variable condition;
     std::atomic<bool> stop; // Atomic flag to signal threads to stop
+    std::atomic<size_t> outstanding{0}; // Queued + running tasks (wait_idle)
+
+    // Work-stealing state
+    bool workStealing = false;
+    struct LocalQueue;
+    std::vector<std::unique_ptr<LocalQueue>> localQueues; // One per worker
+    std::atomic<size_t> sharedPending{0}; // tasks.size(), readable without the lock
+    std::atomic<size_t> urgentPending{0}; // Shared tasks in lanes above the least urgent one
+    std::atomic<size_t> sleepers{0};      // Workers blocked in condition.wait
+
+    // Idle strategy (spin -> yield -> park)
+    std::chrono::nanoseconds idleSpin{0};
+    uint32_t idleYields = 0;
+
+    // Bounded lock-free queue state (replaces `tasks` when set)
+    std::unique_ptr<MPMCQueue<Task>> ring;
+    FullPolicy whenFull = FullPolicy::Block;
+    std::condition_variable notFull;
+    std::atomic<size_t> blockedProducers{0}; // Producers waiting on notFull
+
+    // NUMA state (numaAware only)
+    struct NodeQueue {
+        std::mutex mtx;
+        std::queue<Task, RingDeque<Task>> tasks;
+        std::atomic<size_t> pending{0}; // tasks.size(), readable without the lock
+    };
+    std::vector<std::unique_ptr<NodeQueue>> nodeQueues; // One per node
+    std::vector<size_t> workerNode;                     // Worker -> node
+    std::vector<std::atomic<size_t>> nodeWorkers;       // Node -> number of live workers placed there
+    std::vector<std::vector<int>> workerCpus;           // Worker -> CPUs it is pinned to (empty = anywhere)
+    std::atomic<size_t> pinned{0};                      // Workers whose pinning succeeded
+
+    // Elastic state. A slot goes Stopped -> Running (spawn) -> Retiring (resize/idle) -> Stopped (the worker
+    // left), or Retiring -> Running again if the pool grows before the worker left.
+    enum class Slot : uint8_t { Stopped, Running, Retiring };
+    std::unique_ptr<std::atomic<Slot>[]> slots;
+    std::atomic<size_t> running{0}; // Slots in Running state
+    std::mutex resizeMutex;         // Serializes every Running -> Retiring / -> Running transition
+    bool elastic = false;
+    size_t minThreads = 0;
+    size_t maxThreads = 0;
+    std::chrono::microseconds growAfter{0};
+    std::chrono::milliseconds idleTimeout{0};
+    std::atomic<uint64_t> maxWaitNs{0}; // Longest queue wait of a task started since the last tick
+    std::atomic<uint64_t> started{0};   // Stamped tasks started
+    std::thread controller;
+    std::mutex controlMutex;
+    std::condition_variable controlWake;
+
+    // Timer thread (schedule_after / schedule_every), created on first use.
+    std::chrono::microseconds timerSpin{50};
+    std::mutex timerMutex;                  // Guards timerQueue and timersClosed
+    bool timersClosed = false;              // Set by the destructor: schedule_* adds nothing anymore
+    std::unique_ptr<TimerQueue> timerQueue;
+    std::atomic<uint64_t> droppedTimers{0}; // Timer runs dropped because the queue was full
+
+    // Instrumentation. counters[i]: worker slot i, counters[capacity]: every non-worker thread that ran a task.
+    struct alignas(64) WorkerCounters {
+        std::atomic<uint64_t> executed{0}, stolen{0}, busyNs{0}, waitNs{0};
+        std::atomic<uint64_t> aliveNs{0};        // Lifetime of the slot's previous threads
+        std::atomic<uint64_t> bornNs{kNotAlive}; // When the slot's current thread started
+    };
+    static constexpr uint64_t kNotAlive = ~uint64_t(0);
+    std::unique_ptr<WorkerCounters[]> counters;
+    bool instrument = false;
+    Clock::time_point epoch = Clock::now();             // Trace timestamps count from here
+    std::vector<std::unique_ptr<TraceRing>> traceRings; // Same indexing as counters (traceEvents > 0)
+    std::mutex helperTraceMutex;                        // The helpers' ring has many writers
+
+    // Which pool/worker the current thread belongs to (enqueue from a worker -> its local deque).
+    static inline thread_local ThreadPool* currentPool = nullptr;
+    static inline thread_local size_t currentWorker = 0;
+    static inline thread_local uint32_t taskDepth = 0; // Stamped tasks running on this thread (helping nests them)
+
+    // The Chase-Lev deques need trivially copyable slots, so a locally pushed task is parked in a
+    // Box and the deque holds the pointer. Boxes are recycled, not deleted:
+    // - Each worker keeps a `spare` list of its own boxes (no synchronization).
+    // - A thief that ran a stolen task hands the box back to its home worker through `returned`,
+    //   a lock-free stack (push = CAS, the owner takes the whole list at once = exchange, so no ABA).
+    // Once the boxes in flight cover the working queue depth, local pushes stop allocating.
+    struct Box {
+        Task task;
+        Box* next = nullptr;
+        size_t home = 0;
+    };
+
+    struct LocalQueue {
+        ChaseLevDeque<Box*> deque;
+        std::vector<Box*> spare;              // Owner thread only
+        std::atomic<Box*> returned{nullptr}; // Boxes handed back by other threads
+
+        ~LocalQueue() {
+            for (Box* b : spare) delete b;
+            for (Box* b = returned.load(); b;) delete std::exchange(b, b->next);
+        }
+    };
+
+    Box* box(size_t self, Task&& task) {
+        LocalQueue& q = *localQueues[self];
+        if (q.spare.empty()) {
+            for (Box* b = q.returned.exchange(nullptr, std::memory_order_acquire); b;) {
+                q.spare.push_back(std::exchange(b, b->next));
+            }
+        }
+        Box* b;
+        if (q.spare.empty()) {
+            b = new Box();
+            b->home = self;
+        } else {
+            b = q.spare.back();
+            q.spare.pop_back();
+        }
+        b->task = std::move(task);
+        return b;
+    }
+
+    // Move the task out and give the box back to its home worker.
+    void unbox(Box* b, Task& out) {
+        out = std::move(b->task);
+        LocalQueue& home = *localQueues[b->home];
+        if (currentPool == this && currentWorker == b->home) {
+            home.spare.push_back(b);
+            return;
+        }
+        b->next = home.returned.load(std::memory_order_relaxed);
+        while (!home.returned.compare_exchange_weak(b->next, b, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+        }
+    }
+
+    // Classic worker loop: one shared queue under one mutex.
+    void runSharedQueue(size_t self) {
+        while (true) {
+            if (retiring(self) && leave(self)) {
+                return;
+            }
+            Task task;
+            bool idle = false;
+
+            // Critical Section
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                
+                // Wait until task is available OR pool is stopped (OR this worker is asked to retire)
+                sleepers.fetch_add(1, std::memory_order_relaxed); // Under the lock: enqueue() reads it there
+                auto ready = [this, self] {
+                    return stop || !tasks.empty() || retiring(self);
+                };
+                if (elastic) {
+                    idle = !condition.wait_for(lock, idleTimeout, ready);
+                } else {
+                    condition.wait(lock, ready);
+                }
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+
+                // Exit if stopped and queue is empty
+                if (stop && tasks.empty()) {
+                    return;
+                }
+                if (tasks.empty()) {
+                    lock.unlock();
+                    if (idle) retireIdle(self);
+                    continue; // Retiring or idle: the loop head decides
+                }
+
+                // Get task (most urgent lane first)
+                task = popSharedLocked();
+            } 
+            // lock releases here, allowing other threads to access queue
+
+            // Execute task outside lock (parallelism)
+            task();
+            finishTask();
+        }
+    }
+
+    bool anyLocalWork() const {
+        for (const auto& q : localQueues) {
+            if (!q->deque.emptyApprox()) return true;
+        }
+        return false;
+    }
+
+    // Index into counters/traceRings for the calling thread.
+    size_t thisWorker() const {
+        return currentPool == this ? currentWorker : workers.size();
+    }
+
+    uint64_t sinceEpoch(Clock::time_point t) const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t - epoch).count());
+    }
+
+    void finishTask() {
+        counters[thisWorker()].executed.fetch_add(1, std::memory_order_relaxed);
+        releaseTask();
+    }
+
+    // A task leaves the outstanding count (releaseTask() alone: it was rejected, never ran).
+    void releaseTask() {
+        if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            outstanding.notify_all(); // Wake wait_idle() callers
+        }
+    }
+
+    bool sharedHasWork() const {
+        return ring ? !ring->emptyApprox() : sharedPending.load(std::memory_order_acquire) > 0;
+    }
+
+    // Anything worker `self` could pick up? Lock-free (approximate): used to spin and to park.
+    bool hasWork(size_t self) const {
+        return sharedHasWork() || anyLocalWork() || anyNodeWork(self);
+    }
+
+    // Node work that worker `self` is allowed to take (self == workerNode.size(): any node work).
+    bool anyNodeWork(size_t self) const {
+        size_t myNode = self < workerNode.size() && !nodeQueues.empty() ? workerNode[self] : nodeQueues.size();
+        for (size_t node = 0; node < nodeQueues.size(); ++node) {
+            if (nodeQueues[node]->pending.load(std::memory_order_relaxed) > 0 && mayTakeFromNode(node, myNode)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool retiring(size_t self) const {
+        return slots[self].load(std::memory_order_relaxed) == Slot::Retiring;
+    }
+
+    // Worker `self` (Retiring, nothing of its own left) exits. False if the pool grew and revived it.
+    bool leave(size_t self) {
+        Slot expected = Slot::Retiring;
+        if (!slots[self].compare_exchange_strong(expected, Slot::Stopped)) {
+            return false;
+        }
+        if (!nodeQueues.empty()) {
+            nodeWorkers[workerNode[self]].fetch_sub(1, std::memory_order_relaxed); // Its node's queue is now anyone's
+        }
+        // A notify meant for a task may have woken us instead: pass it on.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (hasWork(workerNode.size())) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            condition.notify_all();
+        }
+        return true;
+    }
+
+    // Worker `self` had no work for idleTimeout: retire it unless the pool is at minThreads.
+    void retireIdle(size_t self) {
+        std::lock_guard<std::mutex> lock(resizeMutex);
+        if (running.load(std::memory_order_relaxed) > minThreads &&
+            slots[self].load(std::memory_order_relaxed) == Slot::Running) {
+            slots[self].store(Slot::Retiring);
+            running.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool lockFreeWorkers() const {
+        return workStealing || ring || !nodeQueues.empty() || idleSpin.count() > 0 || idleYields > 0;
+    }
+
+    bool popNode(size_t node, Task& out) {
+        NodeQueue& q = *nodeQueues[node];
+        if (q.pending.load(std::memory_order_acquire) == 0) return false;
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.tasks.empty()) return false;
+        out = std::move(q.tasks.front());
+        q.tasks.pop();
+        q.pending.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void pushNode(size_t node, Task&& task) {
+        NodeQueue& q = *nodeQueues[node];
+        {
+            std::lock_guard<std::mutex> lock(q.mtx);
+            q.tasks.push(std::move(task));
+            q.pending.fetch_add(1, std::memory_order_release);
+        }
+        // notify_all: a worker of another node may decline the task, so waking "any one" is not enough.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            condition.notify_all();
+        }
+    }
+
+    // May `self` (a worker of node `myNode`, or a non-worker helper) take from `node`'s queue?
+    bool mayTakeFromNode(size_t node, size_t myNode) const {
+        return myNode == nodeQueues.size() || node == myNode || nodeWorkers[node].load(std::memory_order_relaxed) == 0 ||
+               nodeQueues[node]->pending.load(std::memory_order_relaxed) >= 2;
+    }
+
+    // Wake a worker after a lock-free push. The fence pairs with the one in runLockFree():
+    // either we see its sleepers increment, or it sees our task.
+    void wakeWorker() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            condition.notify_one();
+        }
+    }
+
+    // A slot was freed in the ring: wake a producer blocked on a full queue (same pattern).
+    void wakeProducer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (blockedProducers.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            notFull.notify_one();
+        }
+    }
+
+    void runInline(Task& task) {
+        try {
+            task();
+        } catch (...) {
+            finishTask();
+            throw;
+        }
+        finishTask();
+    }
+
+    bool pushRing(Task&& task) {
+        while (!ring->try_push(std::move(task))) {
+            FullPolicy policy = whenFull;
+            if (currentPool == this && (policy == FullPolicy::Block || policy == FullPolicy::Spin)) {
+                policy = FullPolicy::RunInline;
+            }
+            switch (policy) {
+            case FullPolicy::Reject:
+                releaseTask();
+                return false;
+            case FullPolicy::RunInline:
+                runInline(task);
+                return true;
+            case FullPolicy::Spin:
+                std::this_thread::yield();
+                break;
+            case FullPolicy::Block: {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                blockedProducers.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                notFull.wait(lock, [this] { return ring->sizeApprox() < ring->capacity(); });
+                blockedProducers.fetch_sub(1, std::memory_order_relaxed);
+                break;
+            }
+            }
+        }
+        wakeWorker();
+        return true;
+    }
+
+    // Lookup order: own deque -> own node's queue -> shared queue -> other nodes' queues
+    //               -> steal (same node first).
+    // self == workerNode.size() means "not a worker": no own deque or node, take from everyone.
+    // Exception: while an urgent task waits in the shared lanes, it goes first (no priority inversion).
+    bool findWork(size_t self, Task& out) {
+        bool isWorker = self < workerNode.size();
+        size_t n = localQueues.size();
+        if (urgentPending.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (!tasks.empty()) {
+                out = popSharedLocked();
+                return true;
+            }
+        }
+        if (isWorker && self < n) {
+            if (auto b = localQueues[self]->deque.pop()) {
+                unbox(*b, out);
+                return true;
+            }
+        }
+        size_t myNode = isWorker && !nodeQueues.empty() ? workerNode[self] : nodeQueues.size();
+        if (myNode < nodeQueues.size() && popNode(myNode, out)) {
+            return true;
+        }
+        if (ring) {
+            if (ring->try_pop(out)) {
+                wakeProducer();
+                return true;
+            }
+        } else if (sharedPending.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (!tasks.empty()) {
+                out = popSharedLocked();
+                return true;
+            }
+        }
+        for (size_t node = 0; node < nodeQueues.size(); ++node) {
+            if (node != myNode && mayTakeFromNode(node, myNode) && popNode(node, out)) {
+                return true;
+            }
+        }
+        // Two passes when NUMA-aware: victims on our node, then the rest.
+        for (int pass = 0; pass < (nodeQueues.empty() ? 1 : 2); ++pass) {
+            for (size_t i = 1; i <= n; ++i) {
+                size_t victim = (self + i) % n;
+                if (victim == self) continue;
+                if (!nodeQueues.empty() && (workerNode[victim] == myNode) != (pass == 0)) continue;
+                if (auto b = localQueues[victim]->deque.steal()) {
+                    unbox(*b, out);
+                    counters[self].stolen.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Worker loop for the lock-free modes (work stealing, the bounded ring, NUMA queues, spinning).
+    void runLockFree(size_t self) {
+        Task task;
+        IdleBackoff backoff(idleSpin, idleYields);
+        bool spins = idleSpin.count() > 0 || idleYields > 0;
+        while (true) {
+            // A retiring worker first runs what is left in its own deque (nobody else pushes there).
+            if (retiring(self) && (self >= localQueues.size() || localQueues[self]->deque.emptyApprox()) &&
+                leave(self)) {
+                return;
+            }
+            if (findWork(self, task)) {
+                task();
+                task = Task(); // Release captures before possibly sleeping
+                finishTask();
+                continue;
+            }
+            // Not `stop`: a stopping pool with no work must reach the exit check below.
+            if (spins && backoff.wait([this, self] { return hasWork(self) || retiring(self); })) {
+                continue;
+            }
+
+            bool idle = false;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                // Announce we are going to sleep BEFORE the final check. Pairs with the fence in
+                // wakeWorker(): either the producer sees sleepers > 0 and notifies, or we see its task.
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto ready = [this, self] {
+                    return stop || hasWork(self) || retiring(self);
+                };
+                if (elastic) {
+                    idle = !condition.wait_for(lock, idleTimeout, ready);
+                } else {
+                    condition.wait(lock, ready);
+                }
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+                if (stop && !hasWork(workerNode.size())) {
+                    return;
+                }
+            }
+            if (idle) {
+                retireIdle(self);
+            }
+        }
+    }
+
+    // Elastic and instrumented pools stamp each task with its enqueue time (the controller grows on
+    // queue latency; counters and traces record it).
+    // The stamp adds 16 bytes of captures: a callable near the 64-byte limit may move to the heap.
+    template <typename F>
+    Task makeTask(F&& f) {
+        if (!elastic && !instrument) {
+            return Task(std::forward<F>(f));
+        }
+        return Task([this, fn = std::decay_t<F>(std::forward<F>(f)), queued = Clock::now()]() mutable {
+            TaskScope scope(*this, queued);
+            fn();
+        });
+    }
+
+    // Brackets one stamped task (also when it throws, e.g. run inline by a producer).
+    class TaskScope {
+    private:
+        ThreadPool& pool;
+        Clock::time_point queued;
+        Clock::time_point start = Clock::now();
+
+    public:
+        TaskScope(ThreadPool& p, Clock::time_point q) : pool(p), queued(q) {
+            pool.noteStart(queued, start);
+            ++taskDepth;
+        }
+        ~TaskScope() {
+            --taskDepth;
+            pool.noteFinish(queued, start);
+        }
+        TaskScope(const TaskScope&) = delete;
+        TaskScope& operator=(const TaskScope&) = delete;
+    };
+
+    void noteStart(Clock::time_point queued, Clock::time_point start) {
+        if (!elastic) return; // Shared counters: only the controller needs them
+        auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(start - queued).count());
+        uint64_t prev = maxWaitNs.load(std::memory_order_relaxed);
+        while (ns > prev && !maxWaitNs.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+        started.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void noteFinish(Clock::time_point queued, Clock::time_point start) {
+        if (!instrument) return;
+        Clock::time_point finish = Clock::now();
+        size_t w = thisWorker();
+        WorkerCounters& c = counters[w];
+        c.waitNs.fetch_add(sinceEpoch(start) - sinceEpoch(queued), std::memory_order_relaxed);
+        if (taskDepth == 0) {
+            c.busyNs.fetch_add(sinceEpoch(finish) - sinceEpoch(start), std::memory_order_relaxed); // Outermost only
+        }
+        if (traceRings.empty()) return;
+        TaskTraceEvent e{sinceEpoch(queued), sinceEpoch(start), sinceEpoch(finish), static_cast<uint32_t>(w)};
+        if (w < workers.size()) {
+            traceRings[w]->push(e);
+        } else {
+            std::lock_guard<std::mutex> lock(helperTraceMutex);
+            traceRings[w]->push(e);
+        }
+    }
+
+    WorkerStats statsOf(size_t w) const {
+        const WorkerCounters& c = counters[w];
+        WorkerStats s;
+        s.tasksExecuted = c.executed.load(std::memory_order_relaxed);
+        s.tasksStolen = c.stolen.load(std::memory_order_relaxed);
+        if (!instrument) return s;
+        s.busyNs = c.busyNs.load(std::memory_order_relaxed);
+        s.waitNs = c.waitNs.load(std::memory_order_relaxed);
+        uint64_t alive = c.aliveNs.load(std::memory_order_relaxed);
+        uint64_t born = c.bornNs.load(std::memory_order_relaxed);
+        if (born != kNotAlive) {
+            alive += sinceEpoch(Clock::now()) - born;
+        }
+        s.idleNs = w < workers.size() && alive > s.busyNs ? alive - s.busyNs : 0;
+        return s;
+    }
+
+    // Add a timer (starting the timer thread on first use). Once the pool is being destroyed the token
+    // is cancelled instead.
+    CancelToken addTimer(Clock::duration delay, Clock::duration period, Task&& fn, CancelToken token) {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        if (timersClosed) {
+            token.cancel();
+            return token;
+        }
+        if (!timerQueue) {
+            // The timer thread hands each due timer to the workers as a plain task, without blocking.
+            timerQueue = std::make_unique<TimerQueue>(
+                [this](std::shared_ptr<TimerQueue::Timer> timer) {
+                    if (tryEnqueue(makeTask([timer = std::move(timer)] { timer->run(); }))) return true;
+                    droppedTimers.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                },
+                timerSpin);
+        }
+        timerQueue->add(Clock::now() + delay, period, std::move(fn), token);
+        return token;
+    }
+
+    // Under queueMutex, after the lanes changed.
+    void countUrgentLocked() {
+        if (tasks.laneCount() > 1) {
+            urgentPending.store(tasks.size() - tasks.depth(lowestLane()), std::memory_order_release);
+        }
+    }
+
+    Task popSharedLocked() {
+        Task task = tasks.pop();
+        sharedPending.fetch_sub(1, std::memory_order_relaxed);
+        countUrgentLocked();
+        return task;
+    }
+
+    // Push a task from a non-worker thread without ever waiting for room or running it inline.
+    // Returns false (task dropped) if the bounded queue is full.
+    bool tryEnqueue(Task&& task) {
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        if (ring) {
+            if (!ring->try_push(std::move(task))) {
+                releaseTask();
+                return false;
+            }
+            wakeWorker();
+            return true;
+        }
+        pushShared(lowestLane(), std::move(task));
+        return true;
+    }
+
+    void pushShared(size_t lane, Task&& task) {
+        bool wake;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            tasks.push(lane, std::move(task));
+            sharedPending.fetch_add(1, std::memory_order_release);
+            countUrgentLocked();
+            // Workers change `sleepers` under this lock before they park: no one can slip past this check.
+            wake = sleepers.load(std::memory_order_relaxed) > 0;
+        }
+        if (wake) {
+            condition.notify_one(); // Wake up one parked worker (busy or spinning ones find the task anyway)
+        }
+    }
+
+    // Elastic controller: one tick per growAfter, adds at most one worker per tick.
+    void control() {
+        bool wasQueued = false;
+        uint64_t lastStarted = 0;
+        std::unique_lock<std::mutex> lock(controlMutex);
+        while (!controlWake.wait_for(lock, growAfter, [this] { return stop.load(); })) {
+            uint64_t waited = maxWaitNs.exchange(0, std::memory_order_relaxed);
+            uint64_t nowStarted = started.load(std::memory_order_relaxed);
+            bool queued = hasWork(workerNode.size());
+            // Stalled: queued for a whole tick and nothing started (every worker is stuck in a long task).
+            bool stalled = queued && wasQueued && nowStarted == lastStarted;
+            wasQueued = queued;
+            lastStarted = nowStarted;
+            if (waited > static_cast<uint64_t>(std::chrono::nanoseconds(growAfter).count()) || stalled) {
+                std::lock_guard<std::mutex> resizeLock(resizeMutex);
+                size_t n = running.load(std::memory_order_relaxed);
+                if (n < maxThreads) {
+                    resizeLocked(n + 1);
+                }
+            }
+        }
+    }
+
+    // Shared by the submit variants: bind f(args...) into one TaskJob and hand it to `push`,
+    // which queues the pointer-sized runner and returns false if it was rejected.
+    template <typename Push, typename F, typename... Args>
+    auto submitVia(Push&& push, F&& f, Args&&... args) {
+        using R = std::invoke_result_t<std::decay_t<F>&&, std::decay_t<Args>&&...>;
+        auto bound = [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable -> R {
+            return std::invoke(std::move(f), std::move(args)...);
+        };
+        auto* job = new TaskJob<R, decltype(bound)>(std::move(bound));
+        TaskFuture<R> future(job);
+        try {
+            if (!push([job] { job->run(); })) { // Pointer-sized: always stored inline
+                job->cancel(std::make_exception_ptr(TaskRejected()));
+            }
+        } catch (...) {
+            job->release(); // Never queued: drop the job's reference, the future drops the other
+            throw;
+        }
+        return future;
+    }
+
+    // Decide node and CPU set of every worker before any of them starts.
+    void place(size_t numThreads, bool pinWorkers, bool numaAware) {
+        workerNode.assign(numThreads, 0);
+        workerCpus.assign(numThreads, {});
+        if (!pinWorkers && !numaAware) return;
+
+        CpuTopology topo = CpuTopology::detect();
+        std::vector<std::pair<int, size_t>> cpus; // (cpu, node), node by node
+        for (size_t node = 0; node < topo.nodes(); ++node) {
+            for (int cpu : topo.nodeCpus[node]) cpus.emplace_back(cpu, node);
+        }
+        for (size_t i = 0; i < numThreads; ++i) {
+            size_t node;
+            if (pinWorkers) {
+                // Worker i -> i-th CPU (wrapping): consecutive workers share a node.
+                auto [cpu, cpuNode] = cpus[i % cpus.size()];
+                node = cpuNode;
+                workerCpus[i] = {cpu};
+            } else {
+                node = i % topo.nodes(); // Interleaved: any prefix of the slots (elastic pools) spans every node
+                workerCpus[i] = topo.nodeCpus[node];
+            }
+            workerNode[i] = node;
+        }
+        if (numaAware) {
+            nodeWorkers = std::vector<std::atomic<size_t>>(topo.nodes()); // Counted as workers start
+            for (size_t node = 0; node < topo.nodes(); ++node) {
+                nodeQueues.push_back(std::make_unique<NodeQueue>());
+            }
+        }
+    }
+
+    // Start a worker in slot i (Stopped) and wait until it has tried to pin itself. Caller holds resizeMutex.
+    void spawn(size_t i) {
+        if (workers[i].joinable()) {
+            workers[i].join(); // The previous worker already left (or is returning)
+        }
+        slots[i].store(Slot::Running);
+        if (!nodeQueues.empty()) {
+            nodeWorkers[workerNode[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+        std::promise<void> placed;
+        std::future<void> ready = placed.get_future();
+        workers[i] = std::thread([this, i, placed = std::move(placed)]() mutable {
+            currentPool = this;
+            currentWorker = i;
+            uint64_t born = sinceEpoch(Clock::now());
+            counters[i].bornNs.store(born, std::memory_order_relaxed);
+            // Pin from inside the thread, before it touches any memory (first-touch placement).
+            bool isPinned = !workerCpus[i].empty() && pinCurrentThread(workerCpus[i]);
+            if (isPinned) {
+                pinned.fetch_add(1, std::memory_order_relaxed);
+            }
+            placed.set_value();
+            if (lockFreeWorkers()) {
+                runLockFree(i);
+            } else {
+                runSharedQueue(i);
+            }
+            if (isPinned) {
+                pinned.fetch_sub(1, std::memory_order_relaxed);
+            }
+            counters[i].aliveNs.fetch_add(sinceEpoch(Clock::now()) - born, std::memory_order_relaxed);
+            counters[i].bornNs.store(kNotAlive, std::memory_order_relaxed);
+        });
+        ready.wait();
+    }
+
+    // Caller holds resizeMutex. Grows by reviving retiring slots or spawning stopped ones (lowest first),
+    // shrinks by retiring the highest running slots.
+    void resizeLocked(size_t n) {
+        for (size_t i = 0; i < workers.size() && running.load(std::memory_order_relaxed) < n; ++i) {
+            Slot expected = Slot::Retiring;
+            if (slots[i].compare_exchange_strong(expected, Slot::Running)) {
+                running.fetch_add(1, std::memory_order_relaxed); // Revived before it left
+            } else if (expected == Slot::Stopped) {
+                spawn(i);
+                running.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        bool retired = false;
+        for (size_t i = workers.size(); i-- > 0 && running.load(std::memory_order_relaxed) > n;) {
+            if (slots[i].load(std::memory_order_relaxed) == Slot::Running) {
+                slots[i].store(Slot::Retiring);
+                running.fetch_sub(1, std::memory_order_relaxed);
+                retired = true;
+            }
+        }
+        if (retired) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            condition.notify_all(); // Parked retirees must wake up to leave
+        }
+    }
+
+    void start(size_t numThreads, size_t capacity, bool pinWorkers = false, bool numaAware = false,
+               size_t traceEvents = 0) {
+        place(capacity, pinWorkers, numaAware);
+        counters = std::make_unique<WorkerCounters[]>(capacity + 1);
+        if (traceEvents > 0) {
+            for (size_t i = 0; i <= capacity; ++i) {
+                traceRings.push_back(std::make_unique<TraceRing>(traceEvents));
+            }
+        }
+        if (workStealing) {
+            for (size_t i = 0; i < capacity; ++i) {
+                localQueues.push_back(std::make_unique<LocalQueue>());
+            }
+        }
+        workers = std::vector<std::thread>(capacity);
+        slots = std::make_unique<std::atomic<Slot>[]>(capacity); // All Stopped
+        {
+            std::lock_guard<std::mutex> lock(resizeMutex);
+            resizeLocked(numThreads);
+        }
+        if (elastic) {
+            controller = std::thread([this] { control(); });
+        }
+    }
 
 public:
     // Constructor: Launches N threads
     ThreadPool(size_t numThreads = std::thread::hardware_concurrency()) : stop(false) {
-        for (size_t i = 0; i < numThreads; ++i) {
-            workers.emplace_back([this] {
-                while (true) {
-                    std::function<void()> task;
-
-                    // Critical Section
-                    {
-                        std::unique_lock<std::mutex> lock(queueMutex);
-                        
-                        // Wait until task is available OR pool is stopped
-                        condition.wait(lock, [this] {
-                            return stop || !tasks.empty();
-                        });
-
-                        // Exit if stopped and queue is empty
-                        if (stop && tasks.empty()) {
-                            return;
-                        }
-
-                        // Get task
-                        task = std::move(tasks.front());
-                        tasks.pop();
-                    } 
-                    // lock releases here, allowing other threads to access queue
-
-                    // Execute task outside lock (parallelism)
-                    task();
-                }
-            });
+        start(numThreads, numThreads);
+    }
+
+    explicit ThreadPool(const Options& options)
+        : tasks(options.priorityLanes, options.starvationLimit), stop(false), workStealing(options.workStealing),
+          idleSpin(options.idleSpin), idleYields(options.idleYields), whenFull(options.whenFull),
+          timerSpin(options.timerSpin) {
+        if (options.queue == Queue::BoundedLockFree && options.priorityLanes > 1) {
+            throw std::invalid_argument("ThreadPool priority lanes need the mutex queue");
+        }
+        if (options.queue == Queue::BoundedLockFree) {
+            ring = std::make_unique<MPMCQueue<Task>>(options.queueCapacity);
         }
+        minThreads = options.minThreads ? options.minThreads : options.threads;
+        maxThreads = options.maxThreads ? options.maxThreads : options.threads;
+        if (minThreads > options.threads || maxThreads < options.threads || minThreads == 0) {
+            throw std::invalid_argument("ThreadPool needs 1 <= minThreads <= threads <= maxThreads");
+        }
+        elastic = minThreads < maxThreads;
+        growAfter = options.growAfter;
+        idleTimeout = options.idleTimeout;
+        instrument = options.instrument || options.traceEvents > 0;
+        start(options.threads, maxThreads, options.pinWorkers, options.numaAware, options.traceEvents);
     }
 
     // Add task to the pool
     // Can accept lambdas, function pointers, etc.
+    // Returns false only if a full bounded queue rejected it (FullPolicy::Reject).
+    template <typename F>
+    bool enqueue(F&& f) {
+        return enqueue(lowestLane(), std::forward<F>(f));
+    }
+
+    // Add task to a priority lane (0 = most urgent). Throws std::out_of_range for a bad lane.
+    template <typename F>
+    bool enqueue(size_t lane, F&& f) {
+        if (lane >= tasks.laneCount()) {
+            throw std::out_of_range("priority lane out of range");
+        }
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        if (workStealing && currentPool == this && lane == lowestLane()) {
+            // From one of our own workers: lock-free push onto its deque.
+            localQueues[currentWorker]->deque.push(box(currentWorker, makeTask(std::forward<F>(f))));
+            wakeWorker();
+            return true;
+        }
+        if (!nodeQueues.empty() && currentPool == this && lane == lowestLane() && !ring) {
+            pushNode(workerNode[currentWorker], makeTask(std::forward<F>(f))); // Stay on this node
+            return true;
+        }
+        if (ring) {
+            return pushRing(makeTask(std::forward<F>(f)));
+        }
+        pushShared(lane, makeTask(std::forward<F>(f)));
+        return true;
+    }
+
+    // Run f(args...) on the pool. The returned future yields its result or rethrows its exception.
+    // Arguments are copied/moved into the task (like std::thread / std::async).
+    // Careful: waiting on the future from inside a worker of a 1-thread pool deadlocks.
+    template <typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) {
+        return submit_priority(lowestLane(), std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    // submit() into a priority lane (0 = most urgent).
+    template <typename F, typename... Args>
+    auto submit_priority(size_t lane, F&& f, Args&&... args) {
+        return submitVia([this, lane](auto&& job) { return enqueue(lane, std::move(job)); },
+                         std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    // Add task to a NUMA node's queue (numaAware pools). Throws std::out_of_range for a bad node.
+    template <typename F>
+    void enqueue_on_node(size_t node, F&& f) {
+        if (node >= nodeQueues.size()) {
+            throw std::out_of_range("NUMA node out of range");
+        }
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        pushNode(node, makeTask(std::forward<F>(f)));
+    }
+
+    // submit() onto a NUMA node: runs on that node's workers unless they are all busy.
+    template <typename F, typename... Args>
+    auto submit_on_node(size_t node, F&& f, Args&&... args) {
+        return submitVia([this, node](auto&& job) { enqueue_on_node(node, std::move(job)); return true; },
+                         std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    // Run f on the pool once, `delay` from now. Cancel through the returned token (or pass your own
+    // token to cancel several timers at once). A full bounded queue drops the run (droppedTimerRuns()).
+    // While the pool is being destroyed nothing is scheduled: the returned token is already cancelled.
+    template <typename F>
+    CancelToken schedule_after(std::chrono::nanoseconds delay, F&& f, CancelToken token = {}) {
+        return addTimer(delay, Clock::duration::zero(), Task(std::forward<F>(f)), std::move(token));
+    }
+
+    // Run f on the pool every `period` (first run one period from now) until the token is cancelled.
+    // Fixed rate: runs do not drift. A beat that comes due while the previous run is still going is skipped.
     template <typename F>
-    void enqueue(F&& f) {
+    CancelToken schedule_every(std::chrono::nanoseconds period, F&& f, CancelToken token = {}) {
+        if (period <= std::chrono::nanoseconds::zero()) {
+            throw std::invalid_argument("ThreadPool::schedule_every needs a positive period");
+        }
+        return addTimer(period, period, Task(std::forward<F>(f)), std::move(token));
+    }
+
+    // Timer runs dropped because the bounded queue was full when they came due.
+    uint64_t droppedTimerRuns() const {
+        return droppedTimers.load(std::memory_order_relaxed);
+    }
+
+    // Run one queued task on the calling thread. Returns false if nothing was queued.
+    // Used by wait_idle() and TaskGroup::join() to help instead of blocking.
+    bool runPendingTask() {
+        if (lockFreeWorkers()) {
+            Task task;
+            if (!findWork(currentPool == this ? currentWorker : workerNode.size(), task)) return false;
+            task();
+            task = Task();
+            finishTask();
+            return true;
+        }
+        Task task;
         {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            tasks.emplace(std::forward<F>(f));
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (tasks.empty()) return false;
+            task = popSharedLocked();
+        }
+        task();
+        finishTask();
+        return true;
+    }
+
+    // Block until every task enqueued so far (and every task those spawn) has finished.
+    // The caller runs queued tasks while it waits.
+    // Not from inside a pool task: that task counts as outstanding itself. Use a TaskGroup there.
+    void wait_idle() {
+        while (size_t n = outstanding.load(std::memory_order_acquire)) {
+            if (!runPendingTask()) {
+                outstanding.wait(n, std::memory_order_acquire); // Only the last task notifies
+            }
+        }
+    }
+
+    // Workers currently running (elastic pools: changes over time).
+    size_t size() const {
+        return running.load(std::memory_order_relaxed);
+    }
+
+    // Most workers this pool can have (Options::maxThreads).
+    size_t capacity() const {
+        return workers.size();
+    }
+
+    // Set the worker count, 1..capacity(). Queued tasks are kept; a retiring worker finishes its current
+    // task and its own deque before its thread exits. Elastic pools keep adapting from the new size.
+    void resize(size_t n) {
+        if (n == 0 || n > workers.size()) {
+            throw std::invalid_argument("ThreadPool::resize needs 1..capacity() workers");
+        }
+        std::lock_guard<std::mutex> lock(resizeMutex);
+        resizeLocked(n);
+    }
+
+    // Counters of worker slot 0..capacity()-1 (a retired slot keeps its totals). Times need Options::instrument.
+    WorkerStats workerStats(size_t worker) const {
+        if (worker >= workers.size()) {
+            throw std::out_of_range("worker out of range");
+        }
+        return statsOf(worker);
+    }
+
+    // Tasks run by non-worker threads: helping in wait_idle() / TaskGroup::join(), or RunInline.
+    // idleNs is always 0.
+    WorkerStats helperStats() const {
+        return statsOf(workers.size());
+    }
+
+    // Tasks waiting in any queue (approximate while the pool runs).
+    size_t queuedTasks() const {
+        size_t n = ring ? ring->sizeApprox() : sharedPending.load(std::memory_order_relaxed);
+        for (const auto& q : localQueues) {
+            n += static_cast<size_t>(q->deque.sizeApprox());
+        }
+        for (const auto& q : nodeQueues) {
+            n += q->pending.load(std::memory_order_relaxed);
         }
-        condition.notify_one(); // Wake up one worker
+        return n;
+    }
+
+    // Task events still held by the trace rings (Options::traceEvents), sorted by start time.
+    std::vector<TaskTraceEvent> traceEvents() const {
+        std::vector<TaskTraceEvent> events;
+        for (const auto& r : traceRings) {
+            r->collect(events);
+        }
+        std::sort(events.begin(), events.end(),
+                  [](const TaskTraceEvent& a, const TaskTraceEvent& b) { return a.startNs < b.startNs; });
+        return events;
+    }
+
+    // Events overwritten because a ring was full.
+    uint64_t droppedTraceEvents() const {
+        uint64_t n = 0;
+        for (const auto& r : traceRings) {
+            n += r->dropped();
+        }
+        return n;
+    }
+
+    // traceEvents() as Chrome trace-event JSON: one row per worker slot, plus "helpers".
+    void writeChromeTrace(std::ostream& os) const {
+        ::writeChromeTrace(os, traceEvents(), workers.size());
+    }
+
+    size_t lanes() const {
+        return tasks.laneCount();
+    }
+
+    size_t nodes() const {
+        return nodeQueues.size();
+    }
+
+    // Workers successfully pinned to their CPU set (0 if placement was not requested or refused).
+    size_t pinnedWorkers() const {
+        return pinned.load(std::memory_order_relaxed);
+    }
+
+    size_t lowestLane() const {
+        return tasks.laneCount() - 1;
+    }
+
+    // Depth, high-water mark and counters of one priority lane (shared queue only, not local deques).
+    LaneStats laneStats(size_t lane) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return tasks.stats(lane);
     }
 
     // Destructor: Clean shutdown
     ~ThreadPool() {
+        {
+            // First: close the timers, so a task re-arming itself from now on gets a cancelled token...
+            std::lock_guard<std::mutex> lock(timerMutex);
+            timersClosed = true;
+        }
+        timerQueue.reset(); // ...then stop the timer thread (it enqueues). Timers not due yet are dropped
         {
             std::unique_lock<std::mutex> lock(queueMutex);
             stop = true; // Signal stop
         }
+        if (controller.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(controlMutex);
+                controlWake.notify_all();
+            }
+            controller.join(); // Before joining workers: it may still be spawning one
+        }
         condition.notify_all(); // Wake up all threads so they can check 'stop' and exit
 
         for (std::thread& worker : workers) {
@@ -90,4 +1198,75 @@ public:
     }
 };
 
+// Fork/join over a ThreadPool: counts only the tasks started through this group.
+// join() waits for them, running queued pool tasks meanwhile, then rethrows the first exception
+// any of them threw. Safe to use from inside a pool task (nested parallelism).
+class TaskGroup {
+private:
+    ThreadPool& pool;
+    std::atomic<size_t> pending{0};
+    std::mutex mtx; // Guards the last decrement, the wakeup, and firstError
+    std::condition_variable allDone;
+    std::exception_ptr firstError;
+
+    void waitAll() {
+        while (pending.load(std::memory_order_acquire) != 0) {
+            if (pool.runPendingTask()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mtx);
+            allDone.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+        }
+        // The last task decrements under mtx: once we hold it, no task touches this group anymore
+        // and the caller may destroy it.
+        std::lock_guard<std::mutex> lock(mtx);
+    }
+
+    void finishOne(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (error && !firstError) {
+            firstError = error;
+        }
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            allDone.notify_all();
+        }
+    }
+
+public:
+    explicit TaskGroup(ThreadPool& p) : pool(p) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Tasks hold a pointer to this group: never let it die with tasks in flight.
+    ~TaskGroup() {
+        waitAll();
+    }
+
+    template <typename F>
+    void run(F&& f) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        bool queued = pool.enqueue([this, f = std::forward<F>(f)]() mutable {
+            std::exception_ptr error;
+            try {
+                f();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            finishOne(error);
+        });
+        if (!queued) {
+            finishOne(std::make_exception_ptr(TaskRejected()));
+        }
+    }
+
+    void join() {
+        waitAll();
+        std::exception_ptr error = std::exchange(firstError, nullptr);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
 #endif // THREAD_POOL_HPP
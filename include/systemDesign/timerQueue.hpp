@@ -0,0 +1,211 @@
+#ifndef TIMER_QUEUE_HPP
+#define TIMER_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "systemDesign/inlineTask.hpp"
+#include "systemDesign/spinWait.hpp"
+
+// Timer Queue (one timer thread, min-heap of deadlines)
+// Goal: Run work after a delay or every period, without one thread + sleep_for loop per timer.
+// Mechanics:
+// 1. One timer thread owns a binary min-heap of (deadline, sequence number) -> Timer. It sleeps until the
+//    earliest deadline (or until an earlier timer is added), pops every due timer and hands it to `dispatch`
+//    (ThreadPool: a non-blocking push onto the workers' queue). The timer thread never runs the callable
+//    itself, so a slow callback cannot make the other timers late.
+// 2. Heap, not TimerWheel: the wheel rounds deadlines to its tick. Staying under 100 us of jitter would
+//    need a ~50 us tick, i.e. 20k wakeups a second even with nothing due. The heap sleeps exactly until
+//    the next deadline: O(log n) add and pop (10k timers = 14 levels).
+// 3. Jitter: condition_variable::wait_until oversleeps by the kernel's wakeup latency (tens of us, more
+//    under load). The thread wakes `spin` before the deadline and spins (cpuRelax) the rest of the way.
+// 4. Periodic timers are fixed-rate: next deadline = previous deadline + period (not "finished + period"),
+//    so they do not drift. A beat that comes due while the previous run is still running is skipped,
+//    and after a stall the timer jumps to its next future beat: runs never pile up back to back.
+// 5. CancelToken is a shared flag; any number of timers can share one. cancel() stops them all: a run
+//    already handed to the pool checks the flag right before it starts, the heap drops the timer when it
+//    comes due. A run that already started finishes.
+//    Cancelled timers keep their heap slot until then, so every time the heap doubles in size the
+//    cancelled ones are swept out (many long retry timers cancelled on success do not pile up).
+
+// Shared cancellation flag. Copies refer to the same flag.
+class CancelToken {
+private:
+    std::shared_ptr<std::atomic<bool>> flag = std::make_shared<std::atomic<bool>>(false);
+
+public:
+    void cancel() const {
+        flag->store(true, std::memory_order_release);
+    }
+
+    bool cancelled() const {
+        return flag->load(std::memory_order_acquire);
+    }
+};
+
+class TimerQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // One scheduled callable. Shared by the heap entry and the run handed to `dispatch`.
+    class Timer {
+    private:
+        friend class TimerQueue;
+        InlineTask<64> fn;
+        CancelToken token;
+        Clock::duration period; // 0 = one-shot
+        std::atomic<bool> running{false}; // Handed to dispatch and not finished yet
+
+    public:
+        Timer(InlineTask<64> f, CancelToken t, Clock::duration p) : fn(std::move(f)), token(std::move(t)), period(p) {}
+
+        // Called once per dispatch, by whoever runs it (a pool worker).
+        void run() {
+            struct Done {
+                std::atomic<bool>& running;
+                ~Done() { running.store(false, std::memory_order_release); }
+            } done{running};
+            if (!token.cancelled()) {
+                fn();
+            }
+        }
+    };
+
+    // Hands a due timer over to be run. Returns false if it was refused (the run is skipped).
+    // Called on the timer thread: it must not block or run the timer itself, or every other timer is late.
+    using Dispatch = std::function<bool(std::shared_ptr<Timer>)>;
+
+private:
+    struct Entry {
+        Clock::time_point deadline;
+        uint64_t seq; // Equal deadlines fire in the order they were added
+        std::shared_ptr<Timer> timer;
+    };
+    // std::*_heap build a max-heap: "later" compares as smaller so the earliest entry is on top.
+    static bool later(const Entry& a, const Entry& b) {
+        return a.deadline != b.deadline ? a.deadline > b.deadline : a.seq > b.seq;
+    }
+
+    static constexpr size_t kMinSweep = 1024;
+
+    Dispatch dispatch;
+    Clock::duration spin;
+    std::vector<Entry> heap;
+    uint64_t nextSeq = 0;
+    size_t sweepAt = kMinSweep;
+    bool stop = false;
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::thread thread;
+
+    // Drop cancelled timers once the heap has doubled since the last sweep (amortized O(1) per add).
+    void sweepLocked() {
+        if (heap.size() < sweepAt) return;
+        heap.erase(std::remove_if(heap.begin(), heap.end(),
+                                  [](const Entry& e) { return e.timer->token.cancelled(); }),
+                   heap.end());
+        std::make_heap(heap.begin(), heap.end(), later);
+        sweepAt = std::max(kMinSweep, 2 * heap.size());
+    }
+
+    void fire(const std::shared_ptr<Timer>& timer) {
+        if (timer->running.exchange(true, std::memory_order_acq_rel)) {
+            return; // Previous run still going: skip this beat
+        }
+        if (!dispatch(timer)) {
+            timer->running.store(false, std::memory_order_release);
+        }
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!stop) {
+            if (heap.empty()) {
+                wake.wait(lock);
+                continue;
+            }
+            Clock::time_point due = heap.front().deadline;
+            Clock::time_point now = Clock::now();
+            if (now < due - spin) {
+                wake.wait_until(lock, due - spin); // Woken early by an earlier add or by stop: look again
+                continue;
+            }
+            if (now < due) {
+                lock.unlock();
+                while (Clock::now() < due) {
+                    cpuRelax();
+                }
+                lock.lock();
+                continue; // An earlier timer may have been added meanwhile
+            }
+            std::pop_heap(heap.begin(), heap.end(), later);
+            Entry e = std::move(heap.back());
+            heap.pop_back();
+            if (e.timer->token.cancelled()) {
+                continue;
+            }
+            if (e.timer->period > Clock::duration::zero()) {
+                Clock::time_point next = e.deadline + e.timer->period;
+                if (next <= now) {
+                    next += e.timer->period * ((now - next) / e.timer->period + 1); // Skip missed beats
+                }
+                heap.push_back({next, nextSeq++, e.timer});
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+            lock.unlock();
+            fire(e.timer);
+            lock.lock();
+        }
+    }
+
+public:
+    // `spin`: how long before a deadline the thread stops sleeping and spins (0 = never spin).
+    explicit TimerQueue(Dispatch d, Clock::duration spinWindow = std::chrono::microseconds(50))
+        : dispatch(std::move(d)), spin(spinWindow) {
+        thread = std::thread([this] { loop(); });
+    }
+
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+
+    // Timers not yet due are dropped. Runs already dispatched are not waited for.
+    ~TimerQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stop = true;
+        }
+        wake.notify_all();
+        thread.join();
+    }
+
+    // First run at `deadline`, then every `period` after it (period 0 = run once).
+    void add(Clock::time_point deadline, Clock::duration period, InlineTask<64> fn, CancelToken token) {
+        auto timer = std::make_shared<Timer>(std::move(fn), std::move(token), period);
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            sweepLocked();
+            earliest = heap.empty() || deadline < heap.front().deadline;
+            heap.push_back({deadline, nextSeq++, std::move(timer)});
+            std::push_heap(heap.begin(), heap.end(), later);
+        }
+        if (earliest) {
+            wake.notify_one(); // The thread sleeps until the old earliest deadline: make it look again
+        }
+    }
+
+    // Timers in the heap, including cancelled ones not swept out yet.
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return heap.size();
+    }
+};
+
+#endif // TIMER_QUEUE_HPP
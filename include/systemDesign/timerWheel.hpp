@@ -0,0 +1,141 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Hierarchical Timer Wheel
+// Goal: Schedule millions of timeouts and fire the due ones without scanning or sorting everything.
+// Mechanics:
+// 1. Time is an integer "tick" (e.g. 1 tick = 10 ms). The wheel is like a clock face with 64 slots.
+//    A timer due in d ticks (d < 64) goes into slot (expiry % 64); advancing one tick drains one slot.
+// 2. Hierarchy: 4 wheels of 64 slots. Level L covers 64^L ticks per slot, like hours/minutes/seconds.
+//    - A far-away timer sits in a coarse slot. When time reaches that slot it is "cascaded":
+//      re-inserted one level down, closer to its exact tick.
+//    - Every timer is touched at most once per level, so schedule + expire is O(1) amortized.
+//    - 64^4 ticks = 16.7M ticks (~46 hours at 10 ms). Timers further out wait in the top level
+//      and are re-placed each time they cascade.
+// 3. Bounded work: advance() stops after `maxWork` steps (a timer fired or cascaded, or one tick
+//    advanced). The rest stays queued for the next call, so callers hold a lock for one batch at a time.
+// Not thread-safe: the owner provides locking.
+
+template <typename T>
+class TimerWheel {
+private:
+    static constexpr size_t kLevels = 4;
+    static constexpr size_t kBits = 6; // 64 slots per level
+    static constexpr uint64_t kSlots = 1ULL << kBits;
+    static constexpr uint64_t kSpan = 1ULL << (kBits * kLevels); // Ticks covered by the whole wheel
+
+    struct Timer {
+        uint64_t expiry;
+        T payload;
+    };
+
+    std::array<std::array<std::vector<Timer>, kSlots>, kLevels> wheels;
+    std::vector<Timer> due;       // Reached their tick, waiting to be fired
+    std::vector<Timer> cascading; // Taken out of a coarse slot, waiting to be re-placed
+    uint64_t currentTick;
+    size_t count = 0;
+
+    // Put a timer into the right level/slot relative to currentTick.
+    void place(Timer&& t) {
+        if (t.expiry <= currentTick) {
+            due.push_back(std::move(t));
+            return;
+        }
+        uint64_t delta = t.expiry - currentTick;
+        // Beyond the wheel's horizon: park in the top level at the furthest slot we can express.
+        uint64_t slotTick = delta < kSpan ? t.expiry : currentTick + kSpan - 1;
+        delta = slotTick - currentTick;
+
+        size_t level = 0;
+        while ((delta >> (kBits * (level + 1))) != 0) {
+            ++level;
+        }
+        size_t slot = (slotTick >> (kBits * level)) & (kSlots - 1);
+        wheels[level][slot].push_back(std::move(t));
+    }
+
+    // Move a whole slot into a work queue. O(1) when the queue is empty (the common case).
+    static void drainInto(std::vector<Timer>& slot, std::vector<Timer>& queue) {
+        if (queue.empty()) {
+            queue.swap(slot);
+        } else {
+            for (auto& t : slot) {
+                queue.push_back(std::move(t));
+            }
+            slot.clear();
+        }
+    }
+
+    // Advance one tick: expire level 0's slot, and cascade every coarser level whose slot boundary we hit.
+    void tick() {
+        ++currentTick;
+        for (size_t level = 1; level < kLevels; ++level) {
+            if ((currentTick & ((1ULL << (kBits * level)) - 1)) != 0) {
+                break;
+            }
+            size_t slot = (currentTick >> (kBits * level)) & (kSlots - 1);
+            drainInto(wheels[level][slot], cascading);
+        }
+        drainInto(wheels[0][currentTick & (kSlots - 1)], due);
+    }
+
+public:
+    explicit TimerWheel(uint64_t startTick = 0) : currentTick(startTick) {}
+
+    // Fire `payload` once the wheel has advanced to `expiryTick`.
+    void schedule(uint64_t expiryTick, T payload) {
+        place(Timer{expiryTick, std::move(payload)});
+        ++count;
+    }
+
+    // Advance time up to `nowTick`, calling onExpire(payload) for every due timer.
+    // Does at most `maxWork` units of work (one timer fired/cascaded, or one tick advanced).
+    // Returns the number of timers fired. Call again if caughtUp(nowTick) is false.
+    template <typename F>
+    size_t advance(uint64_t nowTick, size_t maxWork, F&& onExpire) {
+        size_t work = 0;
+        size_t fired = 0;
+        while (work < maxWork) {
+            if (!cascading.empty()) {
+                Timer t = std::move(cascading.back());
+                cascading.pop_back();
+                place(std::move(t));
+                ++work;
+            } else if (!due.empty()) {
+                Timer t = std::move(due.back());
+                due.pop_back();
+                --count;
+                ++work;
+                ++fired;
+                onExpire(t.payload);
+            } else if (currentTick < nowTick) {
+                tick();
+                ++work;
+            } else {
+                break;
+            }
+        }
+        return fired;
+    }
+
+    // True when every timer due at or before nowTick has been fired.
+    bool caughtUp(uint64_t nowTick) const {
+        return currentTick >= nowTick && due.empty() && cascading.empty();
+    }
+
+    uint64_t now() const {
+        return currentTick;
+    }
+
+    // Timers scheduled but not fired yet.
+    size_t size() const {
+        return count;
+    }
+};
+
+#endif // TIMER_WHEEL_HPP
@@ -1,10 +1,15 @@
 #include "multithread.hpp"
+#include "benchHarness.hpp"
 #include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 
 // Test that we can call the functions without crashing.
-// Note: These functions print to stdout, capturing output is hard in basic testing without redirecting buffers.
-// For now, we verify they execute.
+// findEven/findOdd return their count; multithreaded() prints its results to stdout.
 TEST(ConcurrencyTest, FindEvenBasic) {
     // Context: Smoke test to ensure the background logic for finding evens runs without throwing exceptions.
     EXPECT_NO_THROW(findEven(0, 100));
@@ -16,7 +21,76 @@ TEST(ConcurrencyTest, FindOddBasic) {
 
 TEST(ConcurrencyTest, MultithreadedExecution) {
     // Context: Verifies the full multithreaded workflow.
-    // Creates threads, runs them parallel (measured by chrono inside), and joins them.
+    // Creates threads, runs them parallel (timed around the threads, not inside them), and joins them.
     // Proper execution without deadlock/crash is the success condition here.
     EXPECT_NO_THROW(multithreaded());
 }
+
+TEST(ConcurrencyTest, RangeCountKernelsMatchBruteForce) {
+    // Context: closed form, scalar and AVX2 kernels must agree with i % m == r checked one by one,
+    // for ranges that do not start at 0 or on a multiple of 8, on 1..8 threads.
+    EXPECT_EQ(findEven(0, 100), 50u);
+    EXPECT_EQ(findOdd(7, 10), 2u);
+
+    std::vector<RangeKernel> kernels = {RangeKernel::Scalar};
+    if (cpuHasAvx2()) {
+        kernels.push_back(RangeKernel::Avx2);
+    } else {
+        RangeCountOptions avx2;
+        avx2.kernel = RangeKernel::Avx2;
+        EXPECT_THROW(countInRange(0, 10, ModulusPredicate::even(), avx2), std::invalid_argument);
+    }
+    ull start = 1'000'003, end = start + 300'011;
+    for (ModulusPredicate pred : {ModulusPredicate::even(), ModulusPredicate::odd(), ModulusPredicate{3, 2},
+                                  ModulusPredicate{7, 0}, ModulusPredicate{1, 0}, ModulusPredicate{1000, 999},
+                                  ModulusPredicate{1ULL << 63, 5}}) {
+        ull expected = 0;
+        for (ull i = start; i < end; ++i) {
+            expected += i % pred.modulus == pred.remainder;
+        }
+        EXPECT_EQ(countInRange(start, end, pred), expected);
+        for (RangeKernel kernel : kernels) {
+            for (unsigned threads : {1u, 3u, 8u}) {
+                RangeCountOptions options;
+                options.closedForm = false;
+                options.kernel = kernel;
+                options.threads = threads;
+                EXPECT_EQ(countInRange(start, end, pred, options), expected) << pred.modulus << " " << threads;
+            }
+        }
+    }
+    EXPECT_EQ(countInRange(start, end, [](ull i) { return i % 10 == 3; }, 4),
+              countInRange(start, end, ModulusPredicate{10, 3}));
+    EXPECT_EQ(countInRange(5, 5, ModulusPredicate::even()), 0u);
+    EXPECT_THROW(countInRange(0, 10, ModulusPredicate{0, 0}), std::invalid_argument);
+    EXPECT_THROW(countInRange(0, 10, ModulusPredicate{2, 2}), std::invalid_argument);
+}
+
+TEST(BenchmarkHarnessTest, ReportsOrderedStatsAndJson) {
+    // Context: flags are consumed from argv, percentiles come out ordered, the filter skips benchmarks,
+    // and names are escaped in the JSON report.
+    BenchmarkHarness::Options options;
+    options.warmup = 1;
+    options.minSample = std::chrono::milliseconds(1);
+    BenchmarkHarness harness(options);
+    char arg0[] = "bench", arg1[] = "--runs=9", arg2[] = "1234", arg3[] = "--filter=count";
+    char* argv[] = {arg0, arg1, arg2, arg3};
+    EXPECT_EQ(harness.parseArgs(4, argv), std::vector<std::string>{"1234"});
+    EXPECT_EQ(harness.settings().runs, 9u);
+
+    const BenchmarkResult* r = harness.run("count \"evens\"", [] { doNotOptimize(findEven(0, 1000)); }, 1000);
+    ASSERT_NE(r, nullptr);
+    EXPECT_EQ(r->samples, 9u);
+    EXPECT_GE(r->iterations, 1u);
+    EXPECT_LE(r->minNs, r->medianNs);
+    EXPECT_LE(r->medianNs, r->p99Ns);
+    EXPECT_EQ(r->p99Ns, r->maxNs); // Nearest rank with < 100 samples
+    EXPECT_GT(r->itemsPerSecond(), 0);
+    EXPECT_EQ(harness.run("skipped", [] {}), nullptr);
+
+    std::ostringstream json;
+    harness.writeJson(json);
+    EXPECT_NE(json.str().find("\"name\": \"count \\\"evens\\\"\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"median_ns\": "), std::string::npos);
+    EXPECT_EQ(harness.all().size(), 1u);
+}